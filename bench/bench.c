@@ -0,0 +1,408 @@
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Local
+#include "ia/config.h"
+#include "ia/kernel.h"
+#include "ia/network.h"
+#include "ia/layer.h"
+#include "ia/neuron.h"
+#include "ia/sample.h"
+#include "ia/random.h"
+
+//--------------------------------------------------------------------------------------------------------------
+// Mesure des performances des chemins critiques (produit scalaire d'un neurone, propagation, retropropagation
+// et mise a jour des poids d'une couche, separees ou fusionnees, sur des entrees denses ou creuses, mise a jour
+// avec moment ou Adam, fonction d'activation exacte ou approchee, apprentissage complet d'un echantillon), sur
+// des entrees synthetiques (aucune image n'est necessaire). Chaque mesure est emise sur une ligne JSON : duree
+// par operation (ns), debit de calcul (GFLOP/s) et, pour les operations portant sur un echantillon,
+// echantillons par seconde.
+//
+// Usage: bench [DUREE_MIN_MS]      (duree minimale de chaque mesure, 100 ms par defaut)
+//--------------------------------------------------------------------------------------------------------------
+
+// Duree minimale par defaut de chaque mesure (en millisecondes)
+#define DEFAULT_DURATION 100
+
+// Dimensions des couches mesurees (nombre d'entrees x nombre de neurones)
+static const uint32_t INPUT_SIZES[] = { 64, 256, 784, 2048 };
+static const uint32_t NEURON_SIZES[] = { 10, 150, 300, 1024 };
+#define NB_INPUT_SIZES ( sizeof( INPUT_SIZES ) / sizeof( INPUT_SIZES[0] ) )
+#define NB_NEURON_SIZES ( sizeof( NEURON_SIZES ) / sizeof( NEURON_SIZES[0] ) )
+
+// Reseaux mesures en apprentissage complet (couches internes, entre une entree et une sortie d'image MNIST)
+static const uint32_t NETWORK_SHAPES[][3] = { { 100, 0, 0 }, { 300, 150, 0 }, { 1024, 512, 256 } };
+#define NB_NETWORK_SHAPES ( sizeof( NETWORK_SHAPES ) / sizeof( NETWORK_SHAPES[0] ) )
+
+// Generateur des entrees synthetiques (identiques d'une execution a l'autre)
+static Random generator;
+
+/** Contexte d'une mesure
+ *
+ */
+typedef struct
+{
+    Network* network;               // Reseau mesure
+    Layer* layer;                   // Couche mesuree
+    Sample* sample;                 // Echantillon synthetique
+    const Real* inputs;             // Entrees de la couche mesuree
+    double stepRate;                // Pas de la mise a jour (voir NETWORK_beginUpdate())
+} Bench;
+
+/** Operation mesuree
+ *
+ */
+typedef void (*BenchFunction)( Bench* bench );
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Mesure de la duree moyenne (en ns) d'une operation, repetee jusqu'a atteindre la duree minimale specifiee
+ *
+ *  Stocke le nombre de repetitions effectuees
+ */
+static double measure( BenchFunction function, Bench* bench, double minDuration, uint64_t* nbIterations );
+
+/** Emission d'une mesure (ligne JSON)
+ *
+ *  Le nombre d'echantillons par operation est nul si l'operation ne porte pas sur un echantillon complet
+ */
+static void emit( const char* name, const char* shape, uint64_t nbIterations, double nsPerOp, double flopPerOp,
+                  uint32_t samplesPerOp );
+
+/** Mesures d'une couche de nbNeurons neurones a nbInputs entrees
+ *
+ */
+static void benchLayer( uint32_t nbInputs, uint32_t nbNeurons, double minDuration );
+
+/** Mesures de la fonction d'activation (sigmoide) d'une couche de nbNeurons neurones, exacte et approchee
+ *
+ */
+static void benchActivation( uint32_t nbNeurons, double minDuration );
+
+/** Mesure de l'apprentissage complet d'un echantillon sur un reseau MNIST de couches internes specifiees
+ *
+ */
+static void benchNetwork( const uint32_t* internals, double minDuration );
+
+/** Creation d'un reseau de la forme specifiee (poids aleatoires, taux d'apprentissage faible)
+ *
+ */
+static Network* createNetwork( uint32_t inputSize, uint16_t nbInternals, const uint32_t* internals,
+                               uint32_t outputSize, uint8_t optimizer );
+
+/** Remplissage d'un vecteur avec des valeurs synthetiques dans l'intervalle 0.0..1.0
+ *
+ */
+static void fill( Real* values, uint32_t size );
+
+// Operations mesurees
+static void runWeightedSum( Bench* bench );
+static void runForward( Bench* bench );
+static void runBackward( Bench* bench );
+static void runUpdateWeights( Bench* bench );
+static void runBackwardUpdate( Bench* bench );
+static void runSigmoidExact( Bench* bench );
+static void runSigmoidFast( Bench* bench );
+static void runApplySample( Bench* bench );
+
+
+//--- main() ----------------------------------------------------------------------------------------------------------
+
+int main( int argc, char* argv[] )
+{
+    // Duree minimale de chaque mesure
+    if( argc > 2 )
+    {
+        fprintf( stderr, "Usage: bench [DUREE_MIN_MS]\n" );
+        return( 1 );
+    }
+    const double minDuration = ( argc == 2 ? atof( argv[1] ) : DEFAULT_DURATION ) * 1e-3;
+
+    // Selection des noyaux de calcul, et initialisation reproductible des entrees synthetiques
+    KERNEL_init();
+    RANDOM_seed( &generator, RANDOM_DEFAULT_SEED, 0 );
+
+    // Mesures des couches, pour chaque combinaison de dimensions
+    for( uint32_t i = 0; i < NB_INPUT_SIZES; ++i )
+    {
+        for( uint32_t j = 0; j < NB_NEURON_SIZES; ++j ) benchLayer( INPUT_SIZES[i], NEURON_SIZES[j], minDuration );
+    }
+
+    // Mesures des fonctions d'activation
+    for( uint32_t j = 0; j < NB_NEURON_SIZES; ++j ) benchActivation( NEURON_SIZES[j], minDuration );
+
+    // Mesures de l'apprentissage complet
+    for( uint32_t i = 0; i < NB_NETWORK_SHAPES; ++i ) benchNetwork( NETWORK_SHAPES[i], minDuration );
+
+    return( 0 );
+}
+
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static double measure( BenchFunction function, Bench* bench, double minDuration, uint64_t* nbIterations )
+{
+    // Premier appel hors mesure (mise en cache des donnees)
+    function( bench );
+
+    // Le nombre de repetitions est double jusqu'a ce que la duree minimale soit atteinte
+    for( uint64_t count = 1; ; count *= 2 )
+    {
+        struct timespec start, end;
+        clock_gettime( CLOCK_MONOTONIC, &start );
+        for( uint64_t i = 0; i < count; ++i ) function( bench );
+        clock_gettime( CLOCK_MONOTONIC, &end );
+        const double duration = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+        if( duration >= minDuration )
+        {
+            *nbIterations = count;
+            return( duration * 1e9 / count );
+        }
+    }
+}
+
+
+static void emit( const char* name, const char* shape, uint64_t nbIterations, double nsPerOp, double flopPerOp,
+                  uint32_t samplesPerOp )
+{
+    fprintf( stdout, "{\"bench\":\"%s\",\"shape\":\"%s\",\"kernel\":\"%s\",\"real\":\"%s\",\"iterations\":%llu,"
+             "\"ns_per_op\":%.1f,\"gflops\":%.3f,\"samples_per_sec\":",
+             name, shape, KERNEL_name(), REAL_NAME, (unsigned long long)nbIterations, nsPerOp, flopPerOp / nsPerOp );
+    if( samplesPerOp > 0 ) fprintf( stdout, "%.1f}\n", samplesPerOp * 1e9 / nsPerOp );
+    else fprintf( stdout, "null}\n" );
+    fflush( stdout );
+}
+
+
+static void benchLayer( uint32_t nbInputs, uint32_t nbNeurons, double minDuration )
+{
+    char shape[32];
+    sprintf( shape, "%ux%u", nbInputs, nbNeurons );
+    const double size = (double)nbInputs * nbNeurons;
+    uint64_t nbIterations = 0;
+
+    // Echantillons synthetiques dense (aucun pixel nul) et creux (un pixel sur cinq non nul, par traits de cinq
+    // pixels comme les images MNIST)
+    Sample* dense = SAMPLE_createEmpty( nbInputs, nbNeurons );
+    Sample* sparse = SAMPLE_createEmpty( nbInputs, nbNeurons );
+    uint8_t* pixels = (uint8_t*)malloc( nbInputs );
+    for( uint32_t i = 0; i < nbInputs; ++i ) pixels[i] = (uint8_t)( 1 + RANDOM_below( &generator, 255 ) );
+    SAMPLE_setPixels( dense, pixels, nbInputs, 255, -1 );
+    for( uint32_t i = 0; i < nbInputs; ++i )
+    {
+        pixels[i] = ( i % 25 < 5 ? (uint8_t)( 1 + RANDOM_below( &generator, 255 ) ) : 0 );
+    }
+    SAMPLE_setPixels( sparse, pixels, nbInputs, 255, -1 );
+    free( pixels );
+
+    // Couche de sortie de nbNeurons neurones, directement reliee a l'entree (dont les sorties sont l'echantillon)
+    Network* network = createNetwork( nbInputs, 0, NULL, nbNeurons, OPTIMIZER_SGD );
+    LAYER_setInput( network->input, dense );
+    Bench bench = { network, network->output, dense, network->input->output };
+    bench.stepRate = NETWORK_beginUpdate( network );
+    for( uint32_t i = 0; i < nbNeurons; ++i ) network->output->error[i] = 1e-3;
+
+    // Somme ponderee des entrees (un neurone par operation)
+    double ns = measure( runWeightedSum, &bench, minDuration, &nbIterations );
+    emit( "NEURON_weightedSum", shape, nbIterations, ns, 2.0 * nbInputs, 0 );
+
+    // Propagation dans la couche
+    ns = measure( runForward, &bench, minDuration, &nbIterations );
+    emit( "LAYER_forward", shape, nbIterations, ns, 2.0 * size, 1 );
+
+    // Mise a jour des poids de la couche
+    ns = measure( runUpdateWeights, &bench, minDuration, &nbIterations );
+    emit( "LAYER_updateWeights", shape, nbIterations, ns, 2.0 * size, 1 );
+
+    // Memes mesures sur l'echantillon creux : seules les entrees non nulles sont parcourues
+    LAYER_setInput( network->input, sparse );
+    bench.inputs = network->input->output;
+    const double sparseSize = (double)sparse->nbNonZero * nbNeurons;
+    ns = measure( runForward, &bench, minDuration, &nbIterations );
+    emit( "LAYER_forward_sparse", shape, nbIterations, ns, 2.0 * sparseSize, 1 );
+    ns = measure( runUpdateWeights, &bench, minDuration, &nbIterations );
+    emit( "LAYER_updateWeights_sparse", shape, nbIterations, ns, 2.0 * sparseSize, 1 );
+    NETWORK_destroy( network );
+
+    // Mise a jour des poids avec moment, puis avec Adam (poids et etat de l'optimiseur parcourus ensemble)
+    const uint8_t optimizers[2] = { OPTIMIZER_MOMENTUM, OPTIMIZER_ADAM };
+    const char* names[2] = { "LAYER_updateWeights_momentum", "LAYER_updateWeights_adam" };
+    const double flops[2] = { 7.0, 13.0 };
+    for( uint32_t i = 0; i < 2; ++i )
+    {
+        network = createNetwork( nbInputs, 0, NULL, nbNeurons, optimizers[i] );
+        bench.stepRate = NETWORK_beginUpdate( network );
+        LAYER_setInput( network->input, dense );
+        for( uint32_t j = 0; j < nbNeurons; ++j ) network->output->error[j] = 1e-3;
+        bench.network = network;
+        bench.layer = network->output;
+        bench.inputs = network->input->output;
+        ns = measure( runUpdateWeights, &bench, minDuration, &nbIterations );
+        emit( names[i], shape, nbIterations, ns, flops[i] * size, 1 );
+        NETWORK_destroy( network );
+    }
+
+    // La retropropagation dans une couche interne de nbInputs neurones parcourt la matrice des poids de la
+    // couche suivante (nbNeurons x nbInputs)
+    network = createNetwork( 1, 1, &nbInputs, nbNeurons, OPTIMIZER_SGD );
+    Layer* layer = network->internals[0];
+    fill( layer->output, nbInputs );
+    for( uint32_t i = 0; i < nbNeurons; ++i ) network->output->error[i] = 1e-3;
+    bench.network = network;
+    bench.layer = layer;
+    bench.stepRate = NETWORK_beginUpdate( network );
+    ns = measure( runBackward, &bench, minDuration, &nbIterations );
+    emit( "LAYER_backward", shape, nbIterations, ns, 2.0 * size, 1 );
+
+    // Retropropagation et mise a jour fusionnees, sur la matrice des poids de la couche de sortie : a comparer
+    // a la somme des mesures LAYER_backward et LAYER_updateWeights
+    bench.layer = network->output;
+    ns = measure( runBackwardUpdate, &bench, minDuration, &nbIterations );
+    emit( "LAYER_backwardUpdate", shape, nbIterations, ns, 4.0 * size, 1 );
+    NETWORK_destroy( network );
+    SAMPLE_destroy( dense );
+    SAMPLE_destroy( sparse );
+}
+
+
+static void benchActivation( uint32_t nbNeurons, double minDuration )
+{
+    char shape[32];
+    sprintf( shape, "%u", nbNeurons );
+    uint64_t nbIterations = 0;
+
+    // Couche interne de nbNeurons neurones (les sorties, deja dans l'intervalle 0.0..1.0, y restent)
+    Network* network = createNetwork( 1, 1, &nbNeurons, 1, OPTIMIZER_SGD );
+    Layer* layer = network->internals[0];
+    fill( layer->output, nbNeurons );
+    Bench bench = { network, layer, NULL, layer->output };
+
+    // Sigmoide calculee neurone par neurone (libm), puis par le noyau vectorise approche (pas d'operations
+    // flottantes comptees : seule la duree par couche est significative)
+    double ns = measure( runSigmoidExact, &bench, minDuration, &nbIterations );
+    emit( "NEURON_forward", shape, nbIterations, ns, 0.0, 0 );
+    ns = measure( runSigmoidFast, &bench, minDuration, &nbIterations );
+    emit( "KERNEL_sigmoid", shape, nbIterations, ns, 0.0, 0 );
+    NETWORK_destroy( network );
+}
+
+
+static void benchNetwork( const uint32_t* internals, double minDuration )
+{
+    // Forme du reseau
+    uint16_t nbInternals = 0;
+    while( nbInternals < 3 && internals[nbInternals] > 0 ) nbInternals++;
+    char shape[64];
+    int length = sprintf( shape, "%u", SAMPLE_IMAGE_SIZE );
+    for( uint16_t i = 0; i < nbInternals; ++i ) length += sprintf( shape + length, "-%u", internals[i] );
+    sprintf( shape + length, "-%u", SAMPLE_OUTPUT_SIZE );
+
+    // Echantillon synthetique etiquete
+    Network* network = createNetwork( SAMPLE_IMAGE_SIZE, nbInternals, internals, SAMPLE_OUTPUT_SIZE, OPTIMIZER_SGD );
+    Sample* sample = SAMPLE_createEmpty( SAMPLE_IMAGE_SIZE, SAMPLE_OUTPUT_SIZE );
+    uint8_t pixels[SAMPLE_IMAGE_SIZE];
+    for( uint32_t i = 0; i < SAMPLE_IMAGE_SIZE; ++i ) pixels[i] = (uint8_t)RANDOM_below( &generator, 256 );
+    SAMPLE_setPixels( sample, pixels, SAMPLE_IMAGE_SIZE, 255, 3 );
+
+    // Operations par echantillon : propagation et mise a jour des poids de chaque couche, et retropropagation
+    // des erreurs dans les couches internes (a travers les poids des couches suivantes)
+    double flop = 0.0;
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        const double size = (double)layer->nbInputs * layer->nbNeurons;
+        flop += ( layer->previous->previous != NULL ? 6.0 : 4.0 ) * size;
+    }
+
+    // Apprentissage de l'echantillon
+    Bench bench = { network, network->output, sample, sample->input };
+    uint64_t nbIterations = 0;
+    const double ns = measure( runApplySample, &bench, minDuration, &nbIterations );
+    emit( "NETWORK_applySample", shape, nbIterations, ns, flop, 1 );
+
+    // Liberation memoire
+    SAMPLE_destroy( sample );
+    NETWORK_destroy( network );
+}
+
+
+static Network* createNetwork( uint32_t inputSize, uint16_t nbInternals, const uint32_t* internals,
+                               uint32_t outputSize, uint8_t optimizer )
+{
+    Config* cfg = CONFIG_create();
+    cfg->inputSize = inputSize;
+    cfg->nbLayers = nbInternals;
+    for( uint16_t i = 0; i < nbInternals; ++i ) cfg->internalSize[i] = internals[i];
+    cfg->outputSize = outputSize;
+    cfg->learningRate = 1e-4;
+    cfg->lambda = 1.0;
+    cfg->optimizer = optimizer;
+    Network* network = NETWORK_create( cfg );
+    CONFIG_destroy( cfg );
+
+    return( network );
+}
+
+
+static void fill( Real* values, uint32_t size )
+{
+    for( uint32_t i = 0; i < size; ++i ) values[i] = (Real)RANDOM_uniform( &generator );
+}
+
+
+static void runWeightedSum( Bench* bench )
+{
+    // Un neurone different a chaque appel (parcours cyclique des lignes de la matrice des poids)
+    static uint32_t neuron = 0;
+    const Layer* layer = bench->layer;
+    neuron = ( neuron + 1 < layer->nbNeurons ? neuron + 1 : 0 );
+    const Real* weights = layer->weights + (size_t)neuron * layer->nbInputs;
+    layer->output[neuron] = NEURON_weightedSum( weights, layer->bias[neuron], layer->nbInputs, bench->inputs );
+}
+
+
+static void runForward( Bench* bench )
+{
+    LAYER_forward( bench->layer, bench->layer->nbInputs, bench->inputs );
+}
+
+
+static void runBackward( Bench* bench )
+{
+    LAYER_backward( bench->layer );
+}
+
+
+static void runUpdateWeights( Bench* bench )
+{
+    LAYER_updateWeights( bench->layer, bench->stepRate );
+}
+
+
+static void runBackwardUpdate( Bench* bench )
+{
+    LAYER_backwardUpdate( bench->layer, bench->stepRate );
+}
+
+
+static void runSigmoidExact( Bench* bench )
+{
+    const Layer* layer = bench->layer;
+    const double lambda = layer->network->lambda;
+    for( uint32_t i = 0; i < layer->nbNeurons; ++i ) layer->output[i] = NEURON_forward( layer->output[i], lambda );
+}
+
+
+static void runSigmoidFast( Bench* bench )
+{
+    KERNEL_sigmoid( bench->layer->output, bench->layer->network->lambda, bench->layer->nbNeurons );
+}
+
+
+static void runApplySample( Bench* bench )
+{
+    NETWORK_applySample( bench->network, bench->sample );
+}
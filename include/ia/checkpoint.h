@@ -0,0 +1,62 @@
+#ifndef _IA_CHECKPOINT_H_
+#define _IA_CHECKPOINT_H_
+
+// System
+#include <stdint.h>
+
+// Local
+#include "ia/network.h"
+#include "ia/config.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: CHECKPOINT
+// Description:
+//      Sauvegarde d'un reseau entraine dans un fichier binaire versionne : topologie, parametres, puis poids et
+//      biais de chaque couche, a des positions alignees sur 64 octets. Le chargement se fait sans copie : le
+//      fichier est projete en memoire, et les couches utilisent directement les poids projetes. Plusieurs
+//      processus d'exploitation partagent ainsi les memes pages (tant qu'ils ne modifient pas les poids)
+//--------------------------------------------------------------------------------------------------------------
+
+// Identifiant et version du format de point de sauvegarde
+#define CHECKPOINT_MAGIC "IACK"
+#define CHECKPOINT_VERSION 1
+
+// Nombre max de couches d'un reseau (couche d'entree, couches internes et couche de sortie)
+#define CHECKPOINT_MAX_LAYERS ( MAX_INTERNALS + 2 )
+
+/** En-tete d'un point de sauvegarde
+ *
+ *  Les dimensions et positions sont indexees par le rang des couches (0 pour la couche d'entree, qui n'a pas
+ *  de poids). Les poids d'une couche forment une matrice (une ligne par neurone), suivie des biais
+ */
+typedef struct
+{
+    char magic[4];                                  // Identifiant du format (CHECKPOINT_MAGIC)
+    uint32_t version;                               // Version du format (CHECKPOINT_VERSION)
+    uint32_t realSize;                              // Taille en octets des reels stockes (4 ou 8)
+    uint32_t nbLayers;                              // Nombre de couches
+    double learningRate;                            // Taux d'apprentissage du reseau
+    double lambda;                                  // Parametre lambda des sigmoides
+    uint32_t batchSize;                             // Taille des lots d'echantillons en apprentissage
+    uint32_t sizes[CHECKPOINT_MAX_LAYERS];          // Dimensions des couches
+    uint64_t weightsOffsets[CHECKPOINT_MAX_LAYERS]; // Positions des matrices des poids dans le fichier
+    uint64_t biasOffsets[CHECKPOINT_MAX_LAYERS];    // Positions des biais dans le fichier
+} CheckpointHeader;
+
+
+/** Sauvegarde du reseau specifie dans un fichier
+ *
+ *  Retourne 0 si le fichier a pu etre ecrit
+ */
+extern int CHECKPOINT_save( const Network* network, const char* fileName );
+
+/** Chargement d'un reseau a partir d'un point de sauvegarde (projection en memoire, sans copie des poids)
+ *
+ *  Le fichier est projete en copie privee : les pages sont partagees avec les autres processus qui chargent
+ *  le meme fichier, et ne sont dupliquees que si le reseau est modifie (apprentissage). Retourne NULL si le
+ *  fichier est invalide, ou s'il a ete produit avec un autre type de reels (voir module REAL)
+ */
+extern Network* CHECKPOINT_load( const char* fileName );
+
+#endif // _IA_CHECKPOINT_H_
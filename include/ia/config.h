@@ -14,6 +14,15 @@
 // Nombre max de couches internes
 #define MAX_INTERNALS 32
 
+// Longueur max des chemins de fichiers
+#define MAX_PATH 256
+
+// Methodes de mise a jour des poids (optimiseurs)
+#define OPTIMIZER_SGD 0                 // Descente de gradient simple (par defaut)
+#define OPTIMIZER_MOMENTUM 1            // Descente de gradient avec moment
+#define OPTIMIZER_NESTEROV 2            // Descente de gradient avec moment de Nesterov
+#define OPTIMIZER_ADAM 3                // Adam (moyennes des gradients et de leurs carres)
+
 /** Structure de donnees associee la configuration
  *
  */
@@ -24,7 +33,31 @@ typedef struct
     uint32_t internalSize[MAX_INTERNALS];   // Dimensions des couches internes
     uint32_t outputSize;                    // Dimension de la couche de sortie
     double learningRate;                    // Taux d'appentissage du reseau
+    uint8_t optimizer;                      // Methode de mise a jour des poids (OPTIMIZER_SGD par defaut)
+    double momentum;                        // Coefficient du moment, ou beta1 pour Adam (0.9 par defaut)
+    double beta2;                           // Coefficient de la moyenne des carres des gradients (Adam)
+    double epsilon;                         // Terme de stabilite numerique (Adam)
     double lambda;                          // Parametre lambda des fonctionis sigmoides des neurones
+    uint8_t fastActivation;                 // Fonctions d'activation approchees et vectorisees (libm sinon)
+    uint32_t batchSize;                     // Taille des lots d'echantillons en apprentissage (1 si nul)
+    uint32_t nbEpochs;                      // Nombre de passes sur les images d'apprentissage (1 par defaut)
+    uint8_t shuffle;                        // Images d'apprentissage melangees a chaque passe
+    uint64_t seed;                          // Graine des tirages aleatoires (poids initiaux, melange)
+    uint32_t nbValidation;                  // Images d'apprentissage mises de cote pour la validation (0 : aucune)
+    uint32_t validationInterval;            // Echantillons appris entre deux validations (0 : fin d'epoque)
+    uint32_t patience;                      // Validations sans amelioration avant l'arret (0 : jamais)
+    uint8_t keepBest;                       // Reseau de la meilleure validation conserve (le dernier sinon)
+    uint32_t nbThreads;                     // Nombre de threads d'apprentissage (1 par defaut, 0 pour tous)
+    uint8_t hogwild;                        // Apprentissage parallele sans synchronisation (Hogwild)
+    uint32_t prefetch;                      // Profondeur de la file de prechargement des images (0 si aucun)
+    uint8_t ingest;                         // Lecture des images d'un repertoire (INGEST_URING par defaut)
+    uint8_t quantize;                       // Test complementaire du reseau quantifie sur 8 bits
+    uint8_t verbosity;                      // Niveau de detail des traces (0 : statistiques periodiques)
+    uint32_t reportInterval;                // Echantillons entre deux statistiques (0 : bilan uniquement)
+    uint8_t reportJson;                     // Statistiques emises en lignes JSON (texte sinon)
+    char trainingPath[MAX_PATH];            // Images d'apprentissage (repertoire, fichier compact ou IDX)
+    char testingPath[MAX_PATH];             // Images de test (repertoire, fichier compact ou IDX)
+    char checkpointPath[MAX_PATH];          // Point de sauvegarde du reseau entraine (si specifie)
 } Config;
 
 
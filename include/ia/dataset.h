@@ -0,0 +1,131 @@
+#ifndef _IA_DATASET_H_
+#define _IA_DATASET_H_
+
+// System
+#include <stdint.h>
+#include <stddef.h>
+
+// Local
+#include "ia/sample.h"
+#include "ia/ingest.h"
+#include "ia/random.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: DATASET
+// Description:
+//      Ensemble d'images etiquetees, accessibles par leur rang. Les images peuvent provenir :
+//      - d'un repertoire d'images PGM "image-<num>-label-<chiffre>.pgm" (une lecture de fichier par image)
+//      - d'un fichier compact (voir DATASET_pack()), projete en memoire : en-tete, etiquettes, puis pixels
+//        bruts. L'acces a une image se resume alors a un decalage de pointeur
+//      - des fichiers IDX de la base MNIST (images et etiquettes), egalement projetes en memoire
+//      Les images d'un repertoire peuvent etre chargees en memoire une fois pour toutes (DATASET_load(), lectures
+//      soumises par paquets, voir module INGEST), de sorte que les passes suivantes ne lisent plus aucun fichier
+//--------------------------------------------------------------------------------------------------------------
+
+// Identifiant et version du format de fichier compact
+#define DATASET_PACK_MAGIC "IAPK"
+#define DATASET_PACK_VERSION 1
+
+/** En-tete d'un fichier compact
+ *
+ *  Les etiquettes (un octet par image) et les pixels (width x height octets par image) suivent l'en-tete, a
+ *  des positions alignees sur 64 octets
+ */
+typedef struct
+{
+    char magic[4];                  // Identifiant du format (DATASET_PACK_MAGIC)
+    uint32_t version;               // Version du format (DATASET_PACK_VERSION)
+    uint32_t nbSamples;             // Nombre d'images
+    uint32_t width;                 // Largeur des images
+    uint32_t height;                // Hauteur des images
+    uint32_t maxValue;              // Valeur maximale des pixels (normalisation)
+    uint64_t labelsOffset;          // Position des etiquettes dans le fichier
+    uint64_t pixelsOffset;          // Position des pixels dans le fichier
+} DatasetHeader;
+
+/** Structure de donnees associee a un ensemble d'images
+ *
+ */
+typedef struct Dataset
+{
+    uint32_t nbSamples;             // Nombre d'images
+    uint32_t imageSize;             // Nombre de pixels par image
+    uint32_t maxValue;              // Valeur maximale des pixels (normalisation)
+    const uint8_t* labels;          // Etiquettes (chiffre) des images
+    const uint8_t* pixels;          // Pixels bruts des images (nul pour un repertoire non charge)
+    const uint32_t* maxValues;      // Valeurs maximales des pixels de chaque image (repertoire charge)
+    char** files;                   // Fichiers images (repertoire uniquement)
+    void* mappings[2];              // Fichiers projetes en memoire
+    size_t mappingSizes[2];         // Tailles des projections
+} Dataset;
+
+
+/** Ouverture d'un ensemble d'images, dont le type est determine automatiquement
+ *
+ *  Le chemin peut designer un repertoire d'images, un fichier compact, ou un fichier d'images IDX. Dans ce
+ *  dernier cas, le fichier des etiquettes est deduit du nom du fichier d'images (train-images-idx3-ubyte
+ *  --> train-labels-idx1-ubyte), sauf si les deux fichiers sont specifies separes par une virgule
+ */
+extern Dataset* DATASET_open( const char* path );
+
+/** Ouverture d'un repertoire d'images PGM
+ *
+ *  Les images sont listees dans l'ordre du repertoire, mais ne sont lues qu'a l'acces
+ */
+extern Dataset* DATASET_openDirectory( const char* imageFolder );
+
+/** Ouverture (projection en memoire) d'un fichier compact
+ *
+ */
+extern Dataset* DATASET_openPacked( const char* fileName );
+
+/** Ouverture (projection en memoire) des fichiers IDX d'images et d'etiquettes de la base MNIST
+ *
+ */
+extern Dataset* DATASET_openIdx( const char* imagesFile, const char* labelsFile );
+
+/** Chargement en memoire de toutes les images d'un repertoire (lecture et decodage des fichiers PGM)
+ *
+ *  Les fichiers sont lus avec la methode specifiee (voir module INGEST), et chaque image est decodee a partir
+ *  du contenu lu, a son rang dans le repertoire. Les pixels bruts sont ensuite lus en memoire, comme pour un
+ *  fichier compact. Sans effet pour un fichier compact ou IDX (deja projete en memoire). Le bilan de la lecture
+ *  est renseigne si stats n'est pas nul. Retourne 0 si toutes les images ont pu etre lues
+ */
+extern int DATASET_load( Dataset* dataset, uint8_t backend, IngestStats* stats );
+
+/** Melange des rangs d'images specifies (permutation aleatoire en place, reproductible pour une meme graine)
+ *
+ *  Algorithme de Fisher-Yates, les tirages etant ceux du generateur specifie (voir module RANDOM)
+ */
+extern void DATASET_shuffle( uint32_t* order, uint32_t count, Random* random );
+
+/** Ecriture d'un ensemble d'images dans un fichier compact
+ *
+ */
+extern int DATASET_pack( const Dataset* dataset, const char* fileName );
+
+/** Nom de l'image de rang specifie (nom du fichier pour un repertoire, NULL sinon)
+ *
+ */
+extern const char* DATASET_getName( const Dataset* dataset, uint32_t index );
+
+/** Creation de l'echantillon associe a l'image de rang specifie
+ *
+ *  Si l'echantillon est etiquete, il sert a l'apprentissage (voir SAMPLE_create())
+ */
+extern Sample* DATASET_getSample( const Dataset* dataset, uint32_t index, uint8_t labelled );
+
+/** Chargement de l'image de rang specifie dans un echantillon existant (sans allocation)
+ *
+ *  L'echantillon doit avoir ete cree avec des entrees de la dimension des images. Retourne 0 si l'image a
+ *  pu etre lue
+ */
+extern int DATASET_loadSample( const Dataset* dataset, uint32_t index, uint8_t labelled, Sample* sample );
+
+/** Destruction d'un ensemble d'images
+ *
+ */
+extern void DATASET_destroy( Dataset* dataset );
+
+#endif // _IA_DATASET_H_
@@ -0,0 +1,66 @@
+#ifndef _IA_EVALUATOR_H_
+#define _IA_EVALUATOR_H_
+
+// System
+#include <stdint.h>
+
+// Local
+#include "ia/network.h"
+#include "ia/workspace.h"
+#include "ia/dataset.h"
+#include "ia/quantized.h"
+#include "ia/report.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: EVALUATOR
+// Description:
+//      Exploitation parallele d'un reseau (deja entraine) sur plusieurs threads. Le reseau est partage en
+//      lecture seule, chaque thread classifiant une partie des echantillons avec son propre espace de travail.
+//      L'exploitation peut aussi porter sur la version quantifiee (8 bits) d'un reseau
+//--------------------------------------------------------------------------------------------------------------
+
+/** Structure de donnees associee a l'exploitation parallele
+ *
+ */
+typedef struct Evaluator
+{
+    const Network* network;         // Reseau partage (lecture seule) par les threads
+    const QuantizedNetwork* quantized; // Reseau quantifie partage par les threads (a la place du reseau)
+    uint32_t nbThreads;             // Nombre de threads d'exploitation
+    uint32_t batchSize;             // Nombre d'echantillons propages ensemble par chaque thread
+    Workspace** workspaces;         // Espaces de travail d'exploitation (un par thread)
+    QuantizedScratch** scratches;   // Buffers de travail du reseau quantifie (un par thread)
+    Sample*** batches;              // Echantillons reutilises d'un lot a l'autre (un lot par thread)
+    uint32_t nbSamples;             // Nombre d'echantillons de l'exploitation en cours
+    const Dataset* dataset;         // Images de l'exploitation en cours
+    int16_t* predicted;             // Chiffres identifies pour chaque echantillon (-1 si image illisible)
+    double* probabilities;          // Probabilites des chiffres identifies
+    Report* report;                 // Suivi de l'exploitation (perte, precision, debit), si specifie
+} Evaluator;
+
+
+/** Creation de l'exploitation parallele du reseau specifie, avec le nombre de threads specifie
+ *
+ *  Si le nombre de threads est nul, tous les coeurs disponibles sont utilises
+ */
+extern Evaluator* EVALUATOR_create( const Network* network, uint32_t nbThreads );
+
+/** Creation de l'exploitation parallele du reseau quantifie specifie, avec le nombre de threads specifie
+ *
+ */
+extern Evaluator* EVALUATOR_createQuantized( const QuantizedNetwork* network, uint32_t nbThreads );
+
+/** Classification des images de l'ensemble specifie
+ *
+ *  Pour chaque image, le chiffre identifie et sa probabilite sont stockes dans les tableaux fournis (le
+ *  chiffre valant -1 si l'image est illisible)
+ */
+extern void EVALUATOR_run( Evaluator* evaluator, const Dataset* dataset, int16_t* predicted, double* probabilities );
+
+/** Destruction de l'exploitation parallele
+ *
+ */
+extern void EVALUATOR_destroy( Evaluator* evaluator );
+
+#endif // _IA_EVALUATOR_H_
@@ -0,0 +1,59 @@
+#ifndef _IA_INGEST_H_
+#define _IA_INGEST_H_
+
+// System
+#include <stdint.h>
+#include <stddef.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: INGEST
+// Description:
+//      Lecture en masse de petits fichiers (images d'un repertoire). Plutot qu'un appel systeme bloquant par
+//      ouverture et par lecture, les demandes sont soumises par paquets a io_uring (Linux 5.6 et plus) :
+//      plusieurs dizaines de fichiers sont ouverts et lus simultanement, et les appels systemes sont mutualises.
+//      Si io_uring n'est pas disponible (noyau ancien, appels systemes filtres), les fichiers sont lus par un
+//      groupe de threads (open/pread/close). Le contenu de chaque fichier est transmis a une fonction de
+//      traitement avec son rang dans la liste, de sorte que l'ordre de la liste est conserve quel que soit
+//      l'ordre de fin des lectures
+//--------------------------------------------------------------------------------------------------------------
+
+// Methodes de lecture des fichiers
+#define INGEST_NONE 0                   // Lecture sequentielle, un fichier a la fois
+#define INGEST_THREADS 1                // Groupe de threads (open/pread/close)
+#define INGEST_URING 2                  // Lectures soumises par paquets a io_uring (par defaut)
+
+/** Fonction de traitement du contenu d'un fichier
+ *
+ *  Le contenu (size octets) est suivi d'un octet nul, et n'est valide que pendant l'appel. Les appels peuvent
+ *  etre simultanes (rangs distincts). Retourne 0 si le contenu a pu etre traite
+ */
+typedef int (*IngestCallback)( void* context, uint32_t index, const uint8_t* data, size_t size );
+
+/** Bilan d'une lecture de fichiers
+ *
+ */
+typedef struct
+{
+    uint8_t backend;                // Methode de lecture effectivement utilisee
+    uint32_t nbFiles;               // Nombre de fichiers lus
+    uint32_t nbFailed;              // Nombre de fichiers illisibles, ou refuses par le traitement
+    uint64_t nbBytes;               // Nombre d'octets lus
+    double duration;                // Duree de la lecture (en secondes)
+} IngestStats;
+
+
+/** Lecture des fichiers specifies avec la methode demandee, et traitement du contenu de chacun
+ *
+ *  Au plus maxSize octets sont lus par fichier. La methode io_uring se replie sur les threads si elle n'est pas
+ *  disponible. Le bilan est renseigne si stats n'est pas nul. Retourne le nombre de fichiers en echec
+ */
+extern uint32_t INGEST_readFiles( uint8_t backend, char* const* files, uint32_t nbFiles, size_t maxSize,
+                                  IngestCallback callback, void* context, IngestStats* stats );
+
+/** Nom de la methode de lecture specifiee
+ *
+ */
+extern const char* INGEST_name( uint8_t backend );
+
+#endif // _IA_INGEST_H_
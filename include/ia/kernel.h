@@ -0,0 +1,109 @@
+#ifndef _IA_KERNEL_H_
+#define _IA_KERNEL_H_
+
+// System
+#include <stdint.h>
+
+// Local
+#include "ia/real.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: KERNEL
+// Description:
+//      Noyaux de calcul vectorises (SSE2, AVX2 ou AVX-512) sur lesquels reposent les calculs des neurones et
+//      des couches. Le jeu de noyaux le plus performant supporte par le processeur est choisi au demarrage
+//      (instruction cpuid), de sorte qu'un meme executable s'adapte aux differentes generations de processeurs.
+//      La variable d'environnement IA_KERNEL (scalar, sse2, avx2 ou avx512) permet de forcer un jeu de noyaux.
+//      Les noyaux operent sur le type Real (double ou simple precision selon la compilation, voir module REAL)
+//--------------------------------------------------------------------------------------------------------------
+
+/** Selection du jeu de noyaux le plus performant pour le processeur courant
+ *
+ *  Retourne le nom du jeu de noyaux retenu. Tant que cette fonction n'a pas ete appelee, les noyaux
+ *  utilises sont ceux du jeu de base (SSE2 sur x86-64, scalaire sinon)
+ */
+extern const char* KERNEL_init();
+
+/** Nom du jeu de noyaux en cours d'utilisation
+ *
+ */
+extern const char* KERNEL_name();
+
+/** Produit scalaire de deux vecteurs de dimension n
+ *
+ */
+extern Real KERNEL_dot( const Real* x, const Real* y, uint32_t n );
+
+/** Ajout a un vecteur y d'un vecteur x multiplie par un scalaire a : y = y + a * x
+ *
+ */
+extern void KERNEL_axpy( Real* y, Real a, const Real* x, uint32_t n );
+
+/** Retro-propagation et mise a jour fusionnees d'un vecteur de poids w : y = y + a * w, puis w = w + b * x
+ *
+ *  La contribution a y utilise les poids avant leur mise a jour, et chaque poids n'est lu qu'une seule fois
+ */
+extern void KERNEL_axpyUpdate( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n );
+
+/** Mise a jour avec moment d'un vecteur de poids w et de sa vitesse v : v = mu.v + s.x, puis w = w + c.x + d.v
+ *
+ *  Le gradient des poids est s.x. Les coefficients c et d couvrent le moment classique (c = 0, d = -taux) et
+ *  celui de Nesterov (c = -taux.s, d = -taux.mu). Chaque poids et sa vitesse ne sont lus et ecrits qu'une fois
+ */
+extern void KERNEL_momentum( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n );
+
+/** Mise a jour Adam d'un vecteur de poids w, de la moyenne m de ses gradients et de celle v de leurs carres
+ *
+ *  Le gradient g des poids est s.x : m = beta1.m + ( 1 - beta1 ).g, v = beta2.v + ( 1 - beta2 ).g^2, puis
+ *  w = w - step.m / ( sqrt( v ) + epsilon ), le pas etant corrige du biais des moyennes (voir module NETWORK).
+ *  Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une fois
+ */
+extern void KERNEL_adam( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                         const Real* x, uint32_t n );
+
+/** Exponentielle approchee des valeurs d'un vecteur, en place : values[i] = exp( scale * values[i] + shift )
+ *
+ *  Reduction de l'argument (x = k.ln2 + r, avec |r| <= ln2/2), developpement de Taylor de exp( r ) a l'ordre 7,
+ *  puis multiplication par 2^k construit dans l'exposant. Erreur relative maximale mesuree : 7.1e-9 en double
+ *  precision (troncature du polynome), 1.0e-7 en simple precision (arrondis, moins de 2 ulp). L'argument est
+ *  borne a [-708, 709] en double precision et a [-87, 88] en simple precision (pas de debordement)
+ */
+extern void KERNEL_exp( Real* values, Real scale, Real shift, uint32_t n );
+
+/** Fonction sigmoide approchee des valeurs d'un vecteur, en place : values[i] = 1 / ( 1 + exp( -lambda * x ) )
+ *
+ *  L'exponentielle est celle de KERNEL_exp(). Erreur absolue maximale mesuree : 1.7e-9 en double precision,
+ *  9.0e-8 en simple precision
+ */
+extern void KERNEL_sigmoid( Real* values, Real lambda, uint32_t n );
+
+/** Produit scalaire entier de deux vecteurs quantifies sur 8 bits, avec accumulation sur 32 bits
+ *
+ *  Le vecteur x (activations) est non signe, et ses valeurs ne doivent pas depasser 127 : la somme de deux
+ *  produits tient alors sur 16 bits signes, ce qui permet l'utilisation des instructions de multiplication
+ *  entiere 8 bits des processeurs (pas de saturation). Le vecteur y (poids) est signe
+ */
+extern int32_t KERNEL_dotInt8( const uint8_t* x, const int8_t* y, uint32_t n );
+
+/** Produit scalaire d'un vecteur creux et d'un vecteur y : somme des values[j] * y[indexes[j]] pour j < n
+ *
+ *  Le vecteur creux est decrit par ses n elements non nuls (values, contigus) et leurs rangs (indexes, croissants
+ *  de preference, de sorte que les elements de y soient lus dans l'ordre de la memoire)
+ */
+extern Real KERNEL_dotSparse( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n );
+
+/** Ajout a un vecteur y d'un vecteur creux multiplie par un scalaire a : y[indexes[j]] += a * values[j] pour j < n
+ *
+ *  Les rangs doivent etre distincts. Seuls les n elements de y designes par les rangs sont lus et ecrits
+ */
+extern void KERNEL_axpySparse( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n );
+
+/** Multiplications-additions independantes sur des registres, sans acces a la memoire (crete de calcul d'un
+ *  coeur) : nbIterations iterations de chaines x = a.x + b sur des vecteurs de la largeur du jeu de noyaux
+ *
+ *  Retourne le nombre d'operations flottantes effectuees. La somme des chaines est stockee dans result
+ */
+extern uint64_t KERNEL_peak( uint32_t nbIterations, Real* result );
+
+#endif // _IA_KERNEL_H_
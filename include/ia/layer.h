@@ -20,15 +20,28 @@ struct Network;
 
 /** Structure de donnees associee a une couche
  *
+ *  Les poids de tous les neurones de la couche sont stockes dans une matrice unique (bloc memoire contigu et
+ *  aligne), a raison d'une ligne de nbInputs poids par neurone. La couche d'entree n'a ni poids ni buffers :
+ *  ses sorties sont directement les entrees de l'echantillon en cours (vue, sans copie)
  */
 typedef struct Layer
 {
+    uint16_t index;             // Rang de la couche dans le reseau (0 pour la couche d'entree)
     uint32_t nbNeurons;         // Nombre de neurones constituant la couche
-    Neuron** neurons;           // Neurones de la couche
-    double* output;             // Valeurs de sortie de la couche (une par neurone)
-    double* error;              // Gradients de l'erreur lors de la retropropagation (un par neurone)
+    uint32_t nbInputs;          // Nombre d'entrees des neurones (soit la taille de la couche precedente)
+    Real* weights;              // Matrice des poids (nbNeurons lignes de nbInputs poids, nul en entree)
+    Real* bias;                 // Biais des neurones de la couche (un par neurone)
+    Real* output;               // Valeurs de sortie de la couche (une par neurone, echantillon en entree)
+    Real* error;                // Gradients de l'erreur lors de la retropropagation (un par neurone, nul en entree)
+    Real* velocity;             // Vitesses (moment) ou moyennes des gradients (Adam), une par poids
+    Real* variance;             // Moyennes des carres des gradients (Adam), une par poids
+    uint8_t mapped;             // Poids et biais projetes en memoire (non liberes avec la couche)
+    uint32_t nbNonZero;         // Nombre de sorties non nulles (couche d'entree, voir LAYER_setInput())
+    const uint32_t* nonZero;    // Rangs des sorties non nulles (couche d'entree)
+    const Real* nonZeroValues;  // Valeurs des sorties non nulles (couche d'entree)
     struct Layer* previous;     // Couche precedente (si nul, on est dans la couche d'entree)
     struct Layer* next;         // Couche suivante (si nul, on est dans la couche de sortie)
+    struct Network* network;    // Reseau auquel appartient la couche
 } Layer;
 
 
@@ -41,29 +54,104 @@ typedef struct Layer
  */
 extern Layer* LAYER_create( struct Network* network, uint32_t size, Layer* previous );
 
-/** Envoi d'un echantillon a la couche
+/** Creation d'une couche de reseau dont les poids et les biais sont fournis
  *
- *  Cette fonction n'est appelee que pour la couche d'entree du reseau
+ *  Les poids et biais ne sont pas copies : la couche utilise directement les buffers fournis (projection en
+ *  memoire d'un point de sauvegarde, voir module CHECKPOINT), qui ne sont pas liberes avec la couche
  */
-extern void LAYER_applySample( Layer* layer, Sample* sample );
+extern Layer* LAYER_createMapped( struct Network* network, uint32_t size, Layer* previous, Real* weights, Real* bias );
 
-/** Propagation des valeurs de sortie provenant de la couche precedente
+/** Entrees d'un echantillon comme sorties de la couche
  *
+ *  Cette fonction n'est appelee que pour la couche d'entree du reseau. Comme les fonctions suivantes, elle ne
+ *  traite que la couche specifiee : l'enchainement des couches est decrit par le plan d'execution du reseau
+ *  (voir module PLAN). Les entrees de l'echantillon (et la liste de ses entrees non nulles) ne sont pas
+ *  copiees : la couche y fait reference jusqu'a l'echantillon suivant, qui doit donc rester valide pendant
+ *  l'execution du plan
  */
-extern void LAYER_forward( Layer* layer, uint32_t nbInputs, const double* inputs, Sample* sample );
+extern void LAYER_setInput( Layer* layer, const Sample* sample );
 
-/** Retro-propagation des gradients de l'erreur provenant de la couche suivante
+/** Propagation dans la couche des valeurs de sortie de la couche precedente
+ *
+ *  Si la couche precedente est la couche d'entree et que ses sorties sont assez creuses, seules les sorties
+ *  non nulles (et les poids correspondants) sont parcourues. Il en est de meme lors de la mise a jour des poids
+ *  par descente de gradient simple (LAYER_updateWeights() et LAYER_backwardUpdate())
+ */
+extern void LAYER_forward( Layer* layer, uint32_t nbInputs, const Real* inputs );
+
+/** Initialisation des gradients d'erreur de la couche en fonction des sorties attendues (echantillon etiquete)
+ *
+ *  Cette fonction n'est appelee que pour la couche de sortie, apres la propagation d'un echantillon qui possede
+ *  des valeurs de sortie attendues. Elle initialise la retro-propagation des gradients de l'erreur
+ */
+extern void LAYER_initError( Layer* layer, const Sample* sample );
+
+/** Retro-propagation dans une couche interne des gradients de l'erreur de la couche suivante
  *
  */
 extern void LAYER_backward( Layer* layer );
 
-/** Mise a jour des poids des neurones de la couche, et de la couche suivante
+/** Mise a jour des poids des neurones de la couche
+ *
+ *  La mise a jour se fait en fonction des gradients d'erreur calcules lors de la derniere retro-propagation,
+ *  et des sorties de la couche precedente lors de la derniere propagation. Le pas de la mise a jour est
+ *  celui retourne par NETWORK_beginUpdate()
+ */
+extern void LAYER_updateWeights( Layer* layer, double stepRate );
+
+/** Retro-propagation des gradients d'erreur de la couche vers la couche precedente et mise a jour des poids
+ *
+ *  Equivalent a LAYER_backward( layer->previous ) suivi de LAYER_updateWeights( layer ), mais la matrice des
+ *  poids n'est parcourue qu'une seule fois : chaque ligne contribue aux erreurs de la couche precedente, puis
+ *  est mise a jour. Si la couche precedente est la couche d'entree, seule la mise a jour est effectuee
+ */
+extern void LAYER_backwardUpdate( Layer* layer, double stepRate );
+
+/** Propagation d'un lot d'echantillons
+ *
+ *  Les entrees (nbSamples lignes de nbInputs valeurs) sont multipliees par la matrice des poids de la couche
+ *  en un seul produit de matrices, puis la fonction d'activation est appliquee. Les sorties (nbSamples lignes
+ *  de nbNeurons valeurs) sont stockees dans le tableau fourni, la couche n'etant pas modifiee
+ */
+extern void LAYER_forwardBatch( const Layer* layer, uint32_t nbSamples, const Real* inputs, Real* outputs );
+
+/** Initialisation des gradients d'erreur d'un lot (couche de sortie uniquement)
+ *
+ */
+extern void LAYER_initErrorBatch( const Layer* layer, uint32_t nbSamples, Sample** samples,
+                                  const Real* outputs, Real* errors );
+
+/** Retro-propagation des gradients d'erreur d'un lot provenant de la couche suivante
+ *
+ *  Les sorties et erreurs sont celles de la couche pour chaque echantillon du lot, les erreurs de la couche
+ *  suivante etant multipliees par la matrice des poids de cette derniere
+ */
+extern void LAYER_backwardBatch( const Layer* layer, uint32_t nbSamples, const Real* outputs,
+                                 const Real* nextErrors, Real* errors );
+
+/** Accumulation des gradients des poids de la couche pour un lot d'echantillons
+ *
+ *  Les gradients (une matrice de memes dimensions que celle des poids) sont sommes sur le lot, a partir des
+ *  erreurs de la couche et de ses entrees (soit les sorties de la couche precedente)
+ */
+extern void LAYER_accumulateGradients( const Layer* layer, uint32_t nbSamples, const Real* errors,
+                                       const Real* inputs, Real* gradients );
+
+/** Mise a jour des poids de la couche a partir des gradients accumules sur un lot
+ *
+ *  Les poids sont ajustes en une seule passe, avec un pas egal a celui de la mise a jour (voir
+ *  NETWORK_beginUpdate()) divise par le nombre d'echantillons du lot. Les gradients sont remis a zero pour le
+ *  lot suivant
+ */
+extern void LAYER_applyGradients( Layer* layer, uint32_t nbSamples, Real* gradients, double stepRate );
+
+/** Mise a jour des poids d'une partie des neurones de la couche a partir des gradients accumules sur un lot
  *
- *  Cette fonction est appelee sur la couche d'entree du reseau, de sorte a mettre a jour l'ensemble des
- *  poids du reseau (pour tous les neurones) a la fin d'une retro-propagation. La mise a jour se fait
- *  alors en fonction des gradients d'erreur qui ont ete calcules lors de cette retro-propagation
+ *  Identique a LAYER_applyGradients(), mais limitee aux neurones first..first+count-1 (de sorte que plusieurs
+ *  threads puissent mettre a jour une meme couche en parallele)
  */
-extern void LAYER_updateWeights( Layer* layer );
+extern void LAYER_applyGradientRows( Layer* layer, uint32_t nbSamples, Real* gradients, double stepRate,
+                                     uint32_t first, uint32_t count );
 
 /** Destruction d'une couche
  *
@@ -0,0 +1,100 @@
+#ifndef _IA_LOADER_H_
+#define _IA_LOADER_H_
+
+// System
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Local
+#include "ia/dataset.h"
+#include "ia/sample.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: LOADER
+// Description:
+//      Prechargement asynchrone des echantillons d'un ensemble d'images. Un thread dedie lit, decode et
+//      normalise les echantillons a venir, et les depose dans une file circulaire bornee sans verrou (un seul
+//      producteur, un seul consommateur), pendant que l'apprentissage consomme les echantillons deja prets.
+//      Les echantillons sont preallouees, et reutilises une fois rendus par le consommateur (LOADER_release()).
+//      Les compteurs d'attente indiquent de quel cote se trouve le goulet d'etranglement : si l'apprentissage
+//      attend souvent, ce sont les entrees/sorties qui limitent le debit
+//--------------------------------------------------------------------------------------------------------------
+
+/** Element de la file : un echantillon et le rang de l'image correspondante
+ *
+ */
+typedef struct
+{
+    Sample* sample;
+    uint32_t index;
+} LoaderSlot;
+
+/** Structure de donnees associee au prechargement
+ *
+ */
+typedef struct Loader
+{
+    const Dataset* dataset;         // Ensemble d'images source
+    uint32_t nbSamples;             // Nombre d'echantillons a charger
+    const uint32_t* order;          // Rangs des images a charger, dans l'ordre (les premieres si nul)
+    uint8_t labelled;               // Echantillons etiquetes (apprentissage) ou non (exploitation)
+    uint32_t capacity;              // Profondeur maximale de la file
+    LoaderSlot* slots;              // File circulaire
+    uint32_t nbBuffers;             // Nombre d'echantillons preallouees (file et echantillons detenus)
+    Sample** samples;               // Echantillons preallouees, utilises a tour de role
+    _Atomic uint64_t released;      // Nombre d'echantillons rendus par le consommateur
+    _Atomic uint64_t head;          // Nombre d'elements retires de la file (consommateur)
+    _Atomic uint64_t tail;          // Nombre d'elements deposes dans la file (producteur)
+    _Atomic uint8_t done;           // Tous les echantillons ont ete deposes
+    _Atomic uint8_t stop;           // Demande d'arret du producteur
+    _Atomic uint8_t failed;         // Une image n'a pas pu etre chargee (chargement interrompu)
+    uint64_t consumerStalls;        // Nombre d'attentes du consommateur (file vide)
+    _Atomic uint64_t producerStalls;// Nombre d'attentes du producteur (file pleine)
+    uint64_t depthSum;              // Somme des profondeurs de la file observees par le consommateur
+    uint64_t nbTaken;               // Nombre d'echantillons retires de la file
+    pthread_t thread;               // Thread producteur
+} Loader;
+
+
+/** Creation du prechargement (et lancement du thread producteur)
+ *
+ *  Les images de rangs order[0..nbSamples-1] (les nbSamples premieres de l'ensemble si order est nul) sont
+ *  chargees dans l'ordre, avec une file de la profondeur specifiee. Le consommateur peut detenir jusqu'a nbHeld
+ *  echantillons avant de les rendre. Les rangs doivent rester valides jusqu'a la destruction du prechargement.
+ *  Retourne NULL si le thread producteur n'a pas pu etre lance
+ */
+extern Loader* LOADER_create( const Dataset* dataset, const uint32_t* order, uint32_t nbSamples, uint8_t labelled,
+                              uint32_t depth, uint32_t nbHeld );
+
+/** Retrait du prochain echantillon de la file (attente s'il n'est pas encore pret)
+ *
+ *  Retourne NULL quand tous les echantillons ont ete retires, ou apres le dernier echantillon charge si une
+ *  image n'a pas pu etre chargee (voir LOADER_failed()). Le rang de l'image correspondante est stocke
+ *  (si specifie). L'echantillon appartient au prechargement, et doit lui etre rendu (LOADER_release())
+ */
+extern Sample* LOADER_next( Loader* loader, uint32_t* index );
+
+/** Restitution des echantillons les plus anciens retires de la file, qui peuvent alors etre reutilises
+ *
+ *  Les echantillons sont rendus dans l'ordre ou ils ont ete retires
+ */
+extern void LOADER_release( Loader* loader, uint32_t count );
+
+/** Nombre d'echantillons prets dans la file
+ *
+ */
+extern uint32_t LOADER_depth( const Loader* loader );
+
+/** Indique si le chargement a ete interrompu par une image illisible
+ *
+ */
+extern int LOADER_failed( const Loader* loader );
+
+/** Destruction du prechargement (arret du thread producteur, et destruction des echantillons)
+ *
+ */
+extern void LOADER_destroy( Loader* loader );
+
+#endif // _IA_LOADER_H_
@@ -0,0 +1,59 @@
+#ifndef _IA_MATRIX_H_
+#define _IA_MATRIX_H_
+
+// System
+#include <stdint.h>
+
+// Local
+#include "ia/real.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: MATRIX
+// Description:
+//      Allocation de matrices de reels stockees ligne par ligne dans un bloc memoire contigu et aligne
+//      sur une ligne de cache (de sorte que les lignes soient parcourues dans l'ordre de la memoire)
+//--------------------------------------------------------------------------------------------------------------
+
+// Alignement des blocs memoire (taille d'une ligne de cache)
+#define MATRIX_ALIGNMENT 64
+
+/** Creation d'une matrice (initialisee a zero) de dimensions specifiees
+ *
+ *  Un vecteur est une matrice a une seule ligne
+ */
+extern Real* MATRIX_create( uint32_t nbRows, uint32_t nbColumns );
+
+/** Produit d'une matrice A (nbRowsA x n) par la transposee d'une matrice B (nbRowsB x n)
+ *
+ *  Le resultat C (nbRowsA x nbRowsB) est tel que C[i][j] = somme( A[i][k] * B[j][k] ). Avec A les entrees
+ *  d'un lot d'echantillons et B la matrice des poids d'une couche, on obtient les sommes ponderees de la
+ *  couche pour tous les echantillons du lot
+ */
+extern void MATRIX_multiplyNT( const Real* a, uint32_t nbRowsA, const Real* b, uint32_t nbRowsB,
+                               uint32_t n, Real* c );
+
+/** Produit d'une matrice A (nbRowsA x n) par une matrice B (n x nbColumnsB)
+ *
+ *  Le resultat C (nbRowsA x nbColumnsB) est tel que C[i][j] = somme( A[i][k] * B[k][j] ). Avec A les
+ *  gradients d'erreur d'un lot pour une couche et B sa matrice des poids, on obtient les erreurs ponderees
+ *  retro-propagees vers la couche precedente
+ */
+extern void MATRIX_multiplyNN( const Real* a, uint32_t nbRowsA, const Real* b, uint32_t nbColumnsB,
+                               uint32_t n, Real* c );
+
+/** Accumulation du produit de la transposee d'une matrice A (n x nbColumnsA) par une matrice B (n x nbColumnsB)
+ *
+ *  Le resultat est ajoute a C (nbColumnsA x nbColumnsB), tel que C[i][j] += somme( A[k][i] * B[k][j] ). Avec
+ *  A les gradients d'erreur d'un lot pour une couche et B les entrees de la couche, on accumule dans C
+ *  la somme sur le lot des gradients des poids
+ */
+extern void MATRIX_accumulateTN( const Real* a, uint32_t nbColumnsA, const Real* b, uint32_t nbColumnsB,
+                                 uint32_t n, Real* c );
+
+/** Destruction d'une matrice
+ *
+ */
+extern void MATRIX_destroy( Real* matrix );
+
+#endif // _IA_MATRIX_H_
@@ -3,11 +3,15 @@
 
 // System
 #include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
 
 // Local
 #include "ia/layer.h"
 #include "ia/config.h"
 #include "ia/sample.h"
+#include "ia/workspace.h"
+#include "ia/plan.h"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -26,6 +30,19 @@ typedef struct Network
     Layer* output;                  // Couche de sortie
     double learningRate;            // Taux d'appentissage du reseau
     double lambda;                  // Parametre lambda des fonctionis sigmoides des neurones
+    uint64_t seed;                  // Graine de l'initialisation des poids (voir module RANDOM)
+    uint8_t optimizer;              // Methode de mise a jour des poids (voir OPTIMIZER_SGD)
+    double momentum;                // Coefficient du moment (beta1 pour Adam)
+    double beta2;                   // Coefficient de la moyenne des carres des gradients (Adam)
+    double epsilon;                 // Terme de stabilite numerique (Adam)
+    atomic_ullong nbUpdates;        // Nombre de mises a jour des poids (etapes d'optimisation)
+    uint8_t fastActivation;         // Fonctions d'activation approchees et vectorisees (voir KERNEL_exp())
+    uint32_t batchSize;             // Taille des lots d'echantillons en apprentissage
+    uint8_t verbosity;              // Niveau de detail des traces (voir module REPORT)
+    Plan* trainingPlan;             // Plan d'execution de l'apprentissage d'un echantillon
+    Plan* inferencePlan;            // Plan d'execution de l'exploitation d'un echantillon
+    void* mapping;                  // Point de sauvegarde projete en memoire (reseau charge, voir CHECKPOINT)
+    size_t mappingSize;             // Taille de la projection
 } Network;
 
 
@@ -34,14 +51,66 @@ typedef struct Network
  */
 extern Network* NETWORK_create( const Config* cfg );
 
+/** Creation d'un reseau de neurones dont les poids et biais sont fournis (sans copie)
+ *
+ *  Les poids et biais de chaque couche sont indexes par le rang de la couche (l'entree 0, correspondant a la
+ *  couche d'entree, n'est pas utilisee). La projection specifiee est liberee avec le reseau
+ */
+extern Network* NETWORK_createMapped( const Config* cfg, Real** weights, Real** bias, void* mapping,
+                                      size_t mappingSize );
+
 /** Envoi d'un echantillon en entree du reseau
  *
  *  Si l'echantillon possede des valeurs de sortie, alors il s'agit d'une phase d'apprentissage. Dans le
  *  cas contraire, il s'agit d'une phase d'exploitation, et les valeurs de sortie sont copiees dans
- *  l'echantillon en sortie du reseau
+ *  l'echantillon en sortie du reseau. Le plan d'execution correspondant (voir module PLAN) est deroule
  */
 extern void NETWORK_applySample( Network* network, Sample* sample );
 
+/** Propagation d'un lot d'echantillons dans le reseau (phase d'exploitation)
+ *
+ *  Le reseau n'est pas modifie : les sorties de chaque couche sont stockees dans l'espace de travail (celles
+ *  de la couche de sortie donnant les probabilites de chaque chiffre). Plusieurs threads peuvent donc
+ *  exploiter un meme reseau simultanement, chacun avec son propre espace de travail
+ */
+extern void NETWORK_infer( const Network* network, Workspace* workspace, Sample** samples, uint32_t nbSamples );
+
+/** Classification d'un echantillon deja propage dans l'espace de travail (voir NETWORK_infer())
+ *
+ *  Retourne le chiffre de plus forte probabilite pour l'echantillon de rang specifie dans le lot, et
+ *  stocke cette probabilite (si specifiee)
+ */
+extern int16_t NETWORK_classify( const Network* network, const Workspace* workspace, uint32_t index,
+                                 double* probability );
+
+/** Calcul des gradients des poids pour un lot d'echantillons etiquetes
+ *
+ *  Les echantillons sont propages couche par couche (un produit de matrices par couche), puis les gradients
+ *  d'erreur sont retro-propages, et les gradients des poids sont sommes dans l'espace de travail. Les poids
+ *  du reseau ne sont pas modifies
+ */
+extern void NETWORK_computeGradients( const Network* network, Workspace* workspace,
+                                      Sample** samples, uint32_t nbSamples );
+
+/** Debut d'une etape de mise a jour des poids (une par echantillon, ou par lot)
+ *
+ *  Compte l'etape (compteur atomique : les threads Hogwild en commencent simultanement), et retourne le pas
+ *  de cette etape, transmis aux mises a jour des couches : le taux d'apprentissage, ou pour Adam le taux
+ *  corrige du biais de ses moyennes (initialisees a zero) : taux.sqrt( 1 - beta2^t ) / ( 1 - beta1^t )
+ */
+extern double NETWORK_beginUpdate( Network* network );
+
+/** Mise a jour des poids du reseau a partir des gradients sommes dans l'espace de travail
+ *
+ */
+extern void NETWORK_applyGradients( Network* network, Workspace* workspace, uint32_t nbSamples );
+
+/** Apprentissage sur un lot d'echantillons etiquetes
+ *
+ *  Les gradients sont calcules sur l'ensemble du lot, et les poids ne sont mis a jour qu'une fois par lot
+ */
+extern void NETWORK_applyBatch( Network* network, Workspace* workspace, Sample** samples, uint32_t nbSamples );
+
 /** Destruction d'un reseau
  *
  */
@@ -4,76 +4,76 @@
 // System
 #include <stdint.h>
 
+// Local
+#include "ia/real.h"
+#include "ia/random.h"
+
 
 //--------------------------------------------------------------------------------------------------------------
 // Module: NEURON
 // Description:
-//      Modelisation d'un neurone du reseau
+//      Modelisation d'un neurone du reseau. Les neurones n'ont pas de structure propre : les poids d'un
+//      neurone forment une ligne de la matrice des poids de sa couche (voir module LAYER), et son biais et
+//      sa sortie sont stockes dans les vecteurs correspondants de la couche. Les fonctions ci-dessous
+//      operent donc sur une ligne de cette matrice
 //--------------------------------------------------------------------------------------------------------------
 
-// Pre-declarations
-struct Network;
-struct Layer;
-
-/** Structure de donnees associee a un neurone
+/** Initialisation des poids d'un neurone
  *
+ *  On fournit la ligne de la matrice des poids associee au neurone, le nombre d'entrees du neurone (soit la
+ *  dimension de la couche precedente), et le generateur pseudo-aleatoire des tirages
  */
-typedef struct Neuron
-{
-    uint32_t index;             // Index du neurone dans sa couche
-    uint32_t nbInputs;          // Nombre d'entrees du neurone (soit la taille de la couche precedente)
-    double* weights;            // Les poids qui ponderent les entrees
-    double bias;                // Biais du neurone
-    double output;              // Derniere sortie calculee (lors de la phase de propagation)
-    struct Network* network;    // Reseau auquel appartient le neurone
-} Neuron;
-
-
-/** Creation d'un neurone
- *
- *  On fournit :
- *  - Le reseau auquel appartient le neurone
- *  - Le nombre d'entrees du neurone (dimension de la couche precedente
- *  - L'index du neurone dans sa couche
- */
-extern Neuron* NEURON_create( struct Network* network, uint32_t nbInputs, uint32_t index );
+extern void NEURON_initWeights( Real* weights, uint32_t nbInputs, Random* random );
 
 /** Calcul de la somme des entrees specifiees ponderees par les poids du neurone
  *
  */
-extern double NEURON_weightedSum( Neuron* neuron, uint32_t nbInputs, const double* inputs );
+extern double NEURON_weightedSum( const Real* weights, double bias, uint32_t nbInputs, const Real* inputs );
 
-/** Propagation des valeurs de sortie provenant de la couche precedente (ou d'une valeur d'entree du reseau)
+/** Application de la fonction de transfert du neurone a la somme ponderee de ses entrees
  *
- *  La fonction applique la fonction de transfert du neurone aux valeurs en entrees, et retourne le resultat.
- *  Le denominateur n'est utilise que par les neurones de la couche de sortie, qui utilise une fonction
- *  d'activation SOFTMAX (contrairement aux couches internes qui utilise la fonction sigmoide)
+ *  Il s'agit de la fonction sigmoide de parametre lambda des couches internes. Les neurones de la couche de
+ *  sortie utilisent la fonction SOFTMAX, qui porte sur toutes les sorties de la couche (voir module LAYER)
  */
-extern double NEURON_forward( Neuron* neuron, uint32_t nbInputs, const double* inputs, double denominator );
+extern double NEURON_forward( double weightedInput, double lambda );
 
 /** Initialise l'erreur du neurone a partir de l'ecart entre la sortie attendue et celle obtenue
  *
  *  Cette fonction est utilisee pour les neurones de la couche de sortie, au demarrage de la
  *  retropropagation des gradients d'erreur (pour les autres couches, on utilise NEURON_backward())
  */
-extern double NEURON_initError( Neuron* neuron, double outputError );
+extern double NEURON_initError( double output, double outputError );
 
-/** Retro-propagation des gradients d'erreur provenant de la couche suivante
+/** Calcul du gradient d'erreur du neurone a partir de la somme des erreurs de la couche suivante
  *
+ *  La somme des erreurs ponderees par les poids des liens entre le neurone et chacun des neurones de la
+ *  couche suivante est calculee par la couche (voir LAYER_backward()), qui parcourt la matrice des poids
+ *  de la couche suivante ligne par ligne
  */
-extern double NEURON_backward( Neuron* neuron, struct Layer* nextLayer );
+extern double NEURON_backward( double output, double lambda, double weightedError );
 
 /** Mise a jour des poids du neurone
  *
  *  La fonction est appelee a la fin de chaque retro-propagation, de sorte à ce que les poids du neurone
- *  soient ajustes en fonction de l'erreur calculee (lors de la retro-propagation) et du taux
- *  d'apprentissage du reseau
+ *  soient ajustes en fonction du pas specifie (produit du taux d'apprentissage et de l'erreur du neurone)
+ *  et des entrees du neurone lors de la derniere propagation
+ */
+extern void NEURON_updateWeights( Real* weights, uint32_t nbInputs, double step, const Real* inputs );
+
+/** Calcul de la somme ponderee d'entrees creuses (seules les nbValues entrees non nulles sont fournies)
+ *
+ *  Les entrees non nulles et leurs rangs sont ceux d'un echantillon (voir SAMPLE_setPixels()) : seuls les poids
+ *  correspondants sont lus
  */
-extern void NEURON_updateWeights( Neuron* neuron, double error, struct Layer* previousLayer );
+extern double NEURON_weightedSumSparse( const Real* weights, double bias, uint32_t nbValues, const uint32_t* indexes,
+                                        const Real* values );
 
-/** Destruction d'un neurone
+/** Mise a jour des poids du neurone pour des entrees creuses
  *
+ *  Identique a NEURON_updateWeights(), mais seuls les poids des nbValues entrees non nulles sont ajustes (les
+ *  autres ne changeraient pas : leur entree est nulle)
  */
-extern void NEURON_destroy( Neuron* neuron );
+extern void NEURON_updateWeightsSparse( Real* weights, uint32_t nbValues, double step, const uint32_t* indexes,
+                                        const Real* values );
 
 #endif // _IA_NEURON_H_
@@ -0,0 +1,73 @@
+#ifndef _IA_PLAN_H_
+#define _IA_PLAN_H_
+
+// System
+#include <stdint.h>
+
+// Local
+#include "ia/layer.h"
+#include "ia/sample.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: PLAN
+// Description:
+//      Plan d'execution d'un reseau : le parcours des couches pour un echantillon est compile une fois pour
+//      toutes (a la creation du reseau) en une liste plate d'etapes, chacune appliquant une operation a une
+//      couche : presentation de l'echantillon en entree, propagation dans chaque couche, initialisation de
+//      l'erreur en sortie (perte), puis, de la couche de sortie a la premiere couche interne, une etape fusionnee
+//      de retro-propagation vers la couche precedente et de mise a jour des poids (PLAN_BACKWARD_UPDATE : chaque
+//      matrice des poids n'est parcourue qu'une fois). Un executeur deroule ensuite ces etapes dans une simple
+//      boucle. Les fonctions des couches ne traitent chacune que leur couche (aucune recursion d'une couche a
+//      l'autre), de sorte que les etapes peuvent etre fusionnees, reordonnees ou reparties entre threads en ne
+//      modifiant que la compilation du plan
+//--------------------------------------------------------------------------------------------------------------
+
+// Pre-declarations
+struct Network;
+
+// Operations des etapes
+#define PLAN_INPUT 0            // Entrees de l'echantillon comme sorties de la couche d'entree (sans copie)
+#define PLAN_FORWARD 1          // Propagation dans la couche des sorties de la couche precedente
+#define PLAN_LOSS 2             // Initialisation des erreurs de la couche de sortie (sorties attendues)
+#define PLAN_OUTPUT 3           // Copie des sorties de la couche de sortie dans l'echantillon
+#define PLAN_BACKWARD_UPDATE 4  // Retro-propagation vers la couche precedente et mise a jour des poids
+
+/** Etape d'un plan d'execution
+ *
+ */
+typedef struct
+{
+    uint8_t operation;              // Operation de l'etape
+    Layer* layer;                   // Couche sur laquelle porte l'operation
+} PlanStep;
+
+/** Structure de donnees associee a un plan d'execution
+ *
+ */
+typedef struct Plan
+{
+    uint32_t nbSteps;               // Nombre d'etapes
+    PlanStep* steps;                // Etapes, dans l'ordre d'execution
+} Plan;
+
+
+/** Compilation du plan d'execution du reseau pour un echantillon
+ *
+ *  Plan d'apprentissage (propagation, perte, retro-propagation et mise a jour des poids) si training est non
+ *  nul, et plan d'exploitation (propagation, et copie des sorties dans l'echantillon) sinon
+ */
+extern Plan* PLAN_create( const struct Network* network, uint8_t training );
+
+/** Execution du plan pour l'echantillon specifie
+ *
+ *  Le pas de la mise a jour (voir NETWORK_beginUpdate()) n'est utilise que par un plan d'apprentissage
+ */
+extern void PLAN_run( const Plan* plan, Sample* sample, double stepRate );
+
+/** Destruction du plan d'execution
+ *
+ */
+extern void PLAN_destroy( Plan* plan );
+
+#endif // _IA_PLAN_H_
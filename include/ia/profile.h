@@ -0,0 +1,70 @@
+#ifndef _IA_PROFILE_H_
+#define _IA_PROFILE_H_
+
+// System
+#include <stdint.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: PROFILE
+// Description:
+//      Compteurs des chemins critiques de l'apprentissage et de l'exploitation : pour chaque couche et chaque
+//      phase (propagation, retropropagation, calcul des gradients, mise a jour des poids), duree cumulee,
+//      nombre d'operations flottantes et nombre d'octets lus ou ecrits. En fin d'execution, un tableau compare
+//      par couche les debits obtenus (GFLOP/s et Go/s) aux cretes de la machine (modele roofline).
+//      Les compteurs ne sont compiles qu'avec l'option IA_PROFILE (make PROFILE=1). Sinon, les macros
+//      ci-dessous sont vides, et l'instrumentation n'a aucun cout
+//--------------------------------------------------------------------------------------------------------------
+
+// Phases instrumentees
+#define PROFILE_FORWARD 0       // Propagation (sommes ponderees et activation)
+#define PROFILE_BACKWARD 1      // Retropropagation des erreurs a travers la matrice des poids (vers la couche
+                                // precedente), comptee sur la couche proprietaire de cette matrice
+#define PROFILE_GRADIENTS 2     // Accumulation des gradients des poids (apprentissage par lots)
+#define PROFILE_UPDATE 3        // Mise a jour des poids
+#define PROFILE_BACKWARD_UPDATE 4   // Retropropagation et mise a jour fusionnees (une passe sur la matrice)
+#define PROFILE_NB_PHASES 5
+
+#ifdef IA_PROFILE
+
+/** Debut de la mesure d'une portion de code (declare la variable start)
+ *
+ */
+#define PROFILE_START( start ) const uint64_t start = PROFILE_now()
+
+/** Fin de la mesure d'une portion de code, et ajout aux compteurs de la couche et de la phase specifiees
+ *
+ */
+#define PROFILE_STOP( start, layer, phase, flop, bytes ) \
+    PROFILE_add( ( layer )->index, ( layer )->nbInputs, ( layer )->nbNeurons, ( phase ), PROFILE_now() - ( start ), \
+                 ( flop ), ( bytes ) )
+
+/** Horloge monotone, en nanosecondes
+ *
+ */
+extern uint64_t PROFILE_now();
+
+/** Ajout d'une mesure aux compteurs de la couche (rang et dimensions) et de la phase specifiees
+ *
+ *  Les compteurs sont atomiques : la fonction peut etre appelee depuis plusieurs threads
+ */
+extern void PROFILE_add( uint16_t layer, uint32_t nbInputs, uint32_t nbNeurons, uint8_t phase, uint64_t duration,
+                         uint64_t flop, uint64_t bytes );
+
+/** Affichage du tableau des compteurs par couche et par phase, compares aux cretes de la machine
+ *
+ *  Les cretes sont mesurees a l'appel (noyaux de calcul selectionnes, un seul coeur : multiplications-additions
+ *  sur des registres pour le calcul, produits scalaires sur un grand volume pour la memoire), sauf si elles
+ *  sont fournies par les variables d'environnement IA_PEAK_GFLOPS et IA_PEAK_GBS
+ */
+extern void PROFILE_report();
+
+#else
+
+#define PROFILE_START( start )
+#define PROFILE_STOP( start, layer, phase, flop, bytes )
+#define PROFILE_report()
+
+#endif // IA_PROFILE
+
+#endif // _IA_PROFILE_H_
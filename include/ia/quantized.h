@@ -0,0 +1,94 @@
+#ifndef _IA_QUANTIZED_H_
+#define _IA_QUANTIZED_H_
+
+// System
+#include <stdint.h>
+#include <stddef.h>
+
+// Local
+#include "ia/network.h"
+#include "ia/sample.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: QUANTIZED
+// Description:
+//      Version quantifiee sur 8 bits d'un reseau entraine, pour l'exploitation seule. Les poids de chaque
+//      neurone sont convertis en entiers signes (-127..127) avec un facteur d'echelle propre a chaque ligne de
+//      la matrice des poids. Les activations (pixels normalises et sorties des sigmoides) etant comprises
+//      entre 0 et 1, elles sont quantifiees avec une echelle fixe (0..127). Les sommes ponderees sont
+//      calculees avec des produits scalaires entiers (accumulation sur 32 bits), puis remises a l'echelle
+//      avant application des fonctions d'activation
+//--------------------------------------------------------------------------------------------------------------
+
+// Valeur entiere correspondant a une activation de 1.0
+#define QUANTIZED_ONE 127
+
+/** Couche quantifiee
+ *
+ */
+typedef struct
+{
+    uint32_t nbNeurons;             // Nombre de neurones de la couche
+    uint32_t nbInputs;              // Nombre d'entrees des neurones
+    int8_t* weights;                // Matrice des poids quantifies (nbNeurons lignes de nbInputs poids)
+    float* scales;                  // Facteurs d'echelle des lignes de la matrice (poids = entier * echelle)
+    float* bias;                    // Biais des neurones
+} QuantizedLayer;
+
+/** Structure de donnees associee a un reseau quantifie
+ *
+ */
+typedef struct QuantizedNetwork
+{
+    uint32_t inputSize;             // Dimension des echantillons en entree
+    uint16_t nbLayers;              // Nombre de couches (internes et sortie, la derniere etant la sortie)
+    QuantizedLayer* layers;         // Couches quantifiees
+    uint32_t maxSize;               // Dimension maximale des couches (taille des buffers d'activations)
+    double lambda;                  // Parametre lambda des sigmoides des couches internes
+} QuantizedNetwork;
+
+/** Buffers de travail pour la classification d'un echantillon par un reseau quantifie
+ *
+ *  Chaque thread doit disposer de ses propres buffers, le reseau quantifie pouvant etre partage
+ */
+typedef struct
+{
+    uint8_t* activations[2];        // Activations quantifiees en entree et en sortie de la couche courante
+    float* values;                  // Sommes ponderees (remises a l'echelle) de la couche courante
+} QuantizedScratch;
+
+
+/** Creation de la version quantifiee d'un reseau entraine (le reseau d'origine n'est pas modifie)
+ *
+ */
+extern QuantizedNetwork* QUANTIZED_create( const Network* network );
+
+/** Taille memoire (en octets) des poids, echelles et biais du reseau quantifie
+ *
+ */
+extern size_t QUANTIZED_size( const QuantizedNetwork* network );
+
+/** Creation des buffers de travail pour le reseau quantifie specifie
+ *
+ */
+extern QuantizedScratch* QUANTIZED_createScratch( const QuantizedNetwork* network );
+
+/** Classification d'un echantillon par le reseau quantifie
+ *
+ *  Retourne le chiffre de plus forte probabilite, et stocke cette probabilite (si specifiee)
+ */
+extern int16_t QUANTIZED_classify( const QuantizedNetwork* network, QuantizedScratch* scratch,
+                                   const Sample* sample, double* probability );
+
+/** Destruction des buffers de travail
+ *
+ */
+extern void QUANTIZED_destroyScratch( QuantizedScratch* scratch );
+
+/** Destruction d'un reseau quantifie
+ *
+ */
+extern void QUANTIZED_destroy( QuantizedNetwork* network );
+
+#endif // _IA_QUANTIZED_H_
@@ -0,0 +1,52 @@
+#ifndef _IA_RANDOM_H_
+#define _IA_RANDOM_H_
+
+// System
+#include <stdint.h>
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: RANDOM
+// Description:
+//      Generateur pseudo-aleatoire xoshiro256** (periode 2^256 - 1, quelques cycles par tirage), a la place de
+//      rand() : l'etat est local a chaque generateur (aucun etat global, donc utilisable par plusieurs threads),
+//      et il est deduit d'une graine et d'un numero de flux. Des flux distincts d'une meme graine sont des
+//      suites independantes : un traitement reparti entre des threads (initialisation des poids, melange) tire
+//      chaque partie de son propre flux, et obtient les memes valeurs quel que soit le nombre de threads
+//--------------------------------------------------------------------------------------------------------------
+
+// Graine par defaut (executions reproductibles si aucune graine n'est configuree)
+#define RANDOM_DEFAULT_SEED 0x1A2B3C4D
+
+/** Etat d'un generateur pseudo-aleatoire
+ *
+ */
+typedef struct
+{
+    uint64_t state[4];              // Etat xoshiro256** (jamais entierement nul)
+} Random;
+
+
+/** Initialisation d'un generateur sur le flux specifie d'une graine
+ *
+ *  L'etat est deduit de la graine et du numero de flux par le generateur SplitMix64
+ */
+extern void RANDOM_seed( Random* random, uint64_t seed, uint64_t stream );
+
+/** Tirage d'un entier de 64 bits
+ *
+ */
+extern uint64_t RANDOM_next( Random* random );
+
+/** Tirage d'un reel uniforme dans l'intervalle [0, 1[ (53 bits significatifs)
+ *
+ */
+extern double RANDOM_uniform( Random* random );
+
+/** Tirage d'un entier uniforme et sans biais dans l'intervalle [0, n[ (n non nul)
+ *
+ *  Multiplication, et rejet des rares tirages qui biaiseraient le resultat (methode de Lemire)
+ */
+extern uint32_t RANDOM_below( Random* random, uint32_t n );
+
+#endif // _IA_RANDOM_H_
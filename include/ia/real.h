@@ -0,0 +1,23 @@
+#ifndef _IA_REAL_H_
+#define _IA_REAL_H_
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: REAL
+// Description:
+//      Type numerique des poids, des sorties, des gradients et des entrees des echantillons. Il s'agit de
+//      reels double precision par defaut, ou de reels simple precision si le projet est compile avec
+//      IA_FLOAT32 (make FLOAT=1) : les vecteurs SIMD contiennent alors deux fois plus de valeurs, et le volume
+//      de donnees transferees depuis la memoire est divise par deux, sans perte de precision notable sur des
+//      images MNIST. Les parametres du reseau (taux d'apprentissage, lambda) restent en double precision
+//--------------------------------------------------------------------------------------------------------------
+
+#ifdef IA_FLOAT32
+typedef float Real;
+#define REAL_NAME "float32"
+#else
+typedef double Real;
+#define REAL_NAME "float64"
+#endif
+
+#endif // _IA_REAL_H_
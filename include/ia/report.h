@@ -0,0 +1,99 @@
+#ifndef _IA_REPORT_H_
+#define _IA_REPORT_H_
+
+// System
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+// Local
+#include "ia/config.h"
+#include "ia/real.h"
+#include "ia/sample.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: REPORT
+// Description:
+//      Suivi de la progression d'une phase (apprentissage ou test) : perte moyenne (entropie croisee), precision
+//      et debit en echantillons par seconde. Les statistiques sont agregees, et emises a intervalle regulier
+//      (tous les N echantillons) sous forme de texte lisible ou de lignes JSON, plutot qu'a chaque echantillon.
+//      Les ajouts sont proteges par un verrou, de sorte que les threads d'apprentissage ou d'exploitation
+//      puissent alimenter un meme suivi (un ajout par lot)
+//--------------------------------------------------------------------------------------------------------------
+
+// Niveaux de detail des traces
+#define REPORT_SUMMARY 0        // Statistiques periodiques et bilans uniquement (par defaut)
+#define REPORT_SAMPLES 1        // Une trace par echantillon
+#define REPORT_DEBUG 2          // Une trace par echantillon, et erreur en sortie du reseau
+
+/** Statistiques cumulees sur un ensemble d'echantillons
+ *
+ */
+typedef struct
+{
+    uint64_t nbSamples;             // Nombre d'echantillons
+    uint64_t nbCorrect;             // Nombre d'echantillons correctement classifies
+    uint64_t nbLoss;                // Nombre d'echantillons dont la perte est connue
+    double loss;                    // Somme des pertes
+    struct timespec start;          // Debut de la periode
+} ReportStats;
+
+/** Structure de donnees associee au suivi d'une phase
+ *
+ */
+typedef struct
+{
+    const char* phase;              // Nom de la phase en cours
+    uint32_t epoch;                 // Epoque d'apprentissage en cours (0 : non affichee)
+    uint8_t json;                   // Emission en lignes JSON (texte sinon)
+    uint32_t interval;              // Nombre d'echantillons entre deux emissions (0 : bilan final uniquement)
+    uint64_t nbExpected;            // Nombre d'echantillons attendus pour la phase
+    uint64_t nextEmission;          // Nombre d'echantillons declenchant la prochaine emission
+    ReportStats total;              // Statistiques depuis le debut de la phase
+    ReportStats window;             // Statistiques depuis la derniere emission
+    pthread_mutex_t mutex;          // Verrou des ajouts
+} Report;
+
+
+/** Creation du suivi, selon la configuration (format et intervalle d'emission)
+ *
+ */
+extern Report* REPORT_create( const Config* cfg );
+
+/** Debut d'une phase, portant sur le nombre d'echantillons specifie
+ *
+ */
+extern void REPORT_begin( Report* report, const char* phase, uint64_t nbExpected );
+
+/** Calcul de la perte (entropie croisee) pour les sorties d'un echantillon de chiffre connu
+ *
+ *  Stocke (si specifie) 1 si le chiffre de plus forte probabilite est le chiffre attendu, 0 sinon
+ */
+extern double REPORT_loss( const Real* outputs, uint32_t nbOutputs, int16_t digit, uint8_t* correct );
+
+/** Ajout des resultats d'un lot d'echantillons
+ *
+ *  La perte est la somme des pertes des echantillons du lot (nbLoss echantillons, 0 si elle n'est pas connue).
+ *  Les statistiques sont emises si l'intervalle d'emission est atteint
+ */
+extern void REPORT_add( Report* report, uint32_t nbSamples, uint32_t nbCorrect, double loss, uint32_t nbLoss );
+
+/** Ajout des resultats d'un lot d'echantillons etiquetes, a partir des sorties du reseau pour ce lot
+ *
+ *  Les sorties des echantillons sont consecutives (nbOutputs valeurs par echantillon)
+ */
+extern void REPORT_addBatch( Report* report, const Real* outputs, uint32_t nbOutputs, Sample** samples,
+                             uint32_t nbSamples );
+
+/** Fin de la phase en cours, et emission du bilan de la phase
+ *
+ */
+extern void REPORT_end( Report* report );
+
+/** Destruction du suivi
+ *
+ */
+extern void REPORT_destroy( Report* report );
+
+#endif // _IA_REPORT_H_
@@ -3,6 +3,10 @@
 
 // System
 #include <stdint.h>
+#include <stddef.h>
+
+// Local
+#include "ia/real.h"
 
 
 //--------------------------------------------------------------------------------------------------------------
@@ -15,19 +19,48 @@
 //      - <chiffre> un chifre entre 0 et 9, qui constitue l'etiquette de l'echantillon en phase d'apprentissage
 //--------------------------------------------------------------------------------------------------------------
 
+// Dimensions des images
+#define SAMPLE_IMAGE_WIDTH 28
+#define SAMPLE_IMAGE_HEIGHT 28
+#define SAMPLE_IMAGE_SIZE ( SAMPLE_IMAGE_WIDTH * SAMPLE_IMAGE_HEIGHT )
+
+// Nombre de sorties attendues d'un echantillon etiquete (une probabilite par chiffre)
+#define SAMPLE_OUTPUT_SIZE 10
+
+// Taille maximale d'un fichier image PGM (en-tete d'au plus 64 octets, et pixels)
+#define SAMPLE_PGM_MAX_SIZE ( 64 + SAMPLE_IMAGE_SIZE )
+
 /** Structure de donnees associee a un echantillon
  *
+ *  Les buffers des entrees et des sorties sont alloues a la creation de l'echantillon, qui peut ensuite etre
+ *  reutilise pour d'autres images sans nouvelle allocation (voir SAMPLE_load() et SAMPLE_setPixels()). Les
+ *  entrees non nulles (la plupart des pixels d'une image sont noirs) sont aussi stockees sous forme compacte,
+ *  avec leurs rangs, pour les calculs de la premiere couche (voir LAYER_forward())
  */
 typedef struct
 {
-    uint32_t inputSize;
-    double* input;
-    uint32_t outputSize;
-    double* output;
-    int16_t digit;
+    uint32_t inputSize;             // Nombre d'entrees (pixels de la derniere image chargee)
+    uint32_t inputCapacity;         // Nombre d'entrees allouees (inputSize ne peut pas le depasser)
+    Real* input;                    // Entrees (pixels normalises)
+    uint32_t nbNonZero;             // Nombre d'entrees non nulles
+    uint32_t* nonZeroIndexes;       // Rangs des entrees non nulles (croissants)
+    Real* nonZeroValues;            // Valeurs des entrees non nulles (contigues)
+    uint32_t outputSize;            // Nombre de sorties
+    Real* output;                   // Sorties attendues, ou obtenues en phase de test
+    int16_t digit;                  // Chiffre de l'image (-1 si l'echantillon n'est pas etiquete)
 } Sample;
 
 
+/** Creation d'un echantillon vide (non etiquete), avec des buffers des dimensions specifiees
+ *
+ */
+extern Sample* SAMPLE_createEmpty( uint32_t inputSize, uint32_t outputSize );
+
+/** Creation d'un ensemble d'echantillons vides, reutilises d'une etape a l'autre (pas d'allocation par image)
+ *
+ */
+extern Sample** SAMPLE_createPool( uint32_t nbSamples, uint32_t inputSize, uint32_t outputSize );
+
 /** Creation d'un echantillon a partir d'une image
  *
  *  Si un chiffre compris entre 0 et 9 est fourni, l'echantillon va servir pour l'apprentissage, et alors
@@ -36,16 +69,56 @@ typedef struct
  */
 extern Sample* SAMPLE_create( const char* imageFile, int16_t digit );
 
+/** Creation d'un echantillon a partir des pixels bruts d'une image
+ *
+ *  Les pixels sont normalises (intervalle 0..1) par rapport a la valeur maximale specifiee. Le chiffre a
+ *  le meme role que pour SAMPLE_create()
+ */
+extern Sample* SAMPLE_createFromPixels( const uint8_t* pixels, uint32_t nbPixels, uint32_t maxValue, int16_t digit );
+
+/** Chargement d'une image dans un echantillon existant (sans allocation)
+ *
+ *  Le chiffre a le meme role que pour SAMPLE_create(). Retourne 0 si l'image a pu etre lue
+ */
+extern int SAMPLE_load( Sample* sample, const char* imageFile, int16_t digit );
+
+/** Chargement des pixels bruts d'une image dans un echantillon existant (sans allocation)
+ *
+ *  Le nombre de pixels ne doit pas depasser le nombre d'entrees allouees a la creation de l'echantillon, qui
+ *  reste disponible pour les images suivantes
+ */
+extern void SAMPLE_setPixels( Sample* sample, const uint8_t* pixels, uint32_t nbPixels, uint32_t maxValue,
+                              int16_t digit );
+
+/** Lecture des pixels bruts (SAMPLE_IMAGE_SIZE octets) et de la valeur maximale d'une image PGM
+ *
+ *  Retourne 0 si l'image a pu etre lue
+ */
+extern int SAMPLE_readImage( const char* imageFile, uint8_t* pixels, uint32_t* maxValue );
+
+/** Decodage d'une image PGM deja lue en memoire : pixels bruts (SAMPLE_IMAGE_SIZE octets) et valeur maximale
+ *
+ *  Le contenu du fichier (size octets) doit etre suivi d'un octet nul. Le nom du fichier n'est utilise que pour
+ *  les messages d'erreur. Retourne 0 si l'image a pu etre decodee
+ */
+extern int SAMPLE_parseImage( const char* imageFile, const uint8_t* data, size_t size, uint8_t* pixels,
+                              uint32_t* maxValue );
+
 /** Copie et normalisation (intervalle 0..1 ) des valeurs de sorties
  *
  *  Cette fonction est appelee en phase d'exploitation pour stocker le resultat en sortie du reseau
  *  pour l'echantillon specifie
  */
-extern void SAMPLE_setOutput( Sample* sample, uint32_t nbValues, const double* values );
+extern void SAMPLE_setOutput( Sample* sample, uint32_t nbValues, const Real* values );
 
 /** Destruction d'un echantillon
  *
  */
 extern void SAMPLE_destroy( Sample* sample );
 
+/** Destruction d'un ensemble d'echantillons
+ *
+ */
+extern void SAMPLE_destroyPool( Sample** pool, uint32_t nbSamples );
+
 #endif // _IA_SAMPLE_H_
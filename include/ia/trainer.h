@@ -0,0 +1,69 @@
+#ifndef _IA_TRAINER_H_
+#define _IA_TRAINER_H_
+
+// System
+#include <stdint.h>
+#include <pthread.h>
+
+// Local
+#include "ia/network.h"
+#include "ia/config.h"
+#include "ia/workspace.h"
+#include "ia/dataset.h"
+#include "ia/report.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: TRAINER
+// Description:
+//      Apprentissage parallele (par donnees) d'un reseau sur plusieurs threads. Chaque thread traite une partie
+//      des echantillons avec son propre espace de travail, sur le reseau partage. Les gradients sont combines :
+//      - soit de maniere synchrone : a chaque etape, chaque thread calcule les gradients d'un lot, puis les
+//        threads somment ensemble les gradients de tous les lots et mettent a jour les poids (chaque thread
+//        traitant une partie des neurones de chaque couche)
+//      - soit sans synchronisation (Hogwild) : chaque thread met a jour les poids partages apres chacun de
+//        ses lots, sans verrou. Les mises a jour concurrentes sont rares et peu genantes (poids peu correles)
+//--------------------------------------------------------------------------------------------------------------
+
+/** Structure de donnees associee a l'apprentissage parallele
+ *
+ */
+typedef struct Trainer
+{
+    Network* network;               // Reseau partage par les threads
+    uint32_t nbThreads;             // Nombre de threads d'apprentissage
+    uint8_t hogwild;                // Mise a jour des poids sans synchronisation
+    uint32_t batchSize;             // Taille des lots traites par chaque thread
+    Workspace** workspaces;         // Espaces de travail (un par thread)
+    Sample*** batches;              // Echantillons reutilises d'un lot a l'autre (un lot par thread)
+    pthread_barrier_t barrier;      // Barriere de synchronisation des threads (mode synchrone)
+    pthread_mutex_t gate;           // Verrou retenant les threads jusqu'au lancement de tous les threads
+    uint8_t aborted;                // Apprentissage abandonne (un thread n'a pas pu etre lance)
+    uint32_t* nbLoaded;             // Nombre d'echantillons charges par chaque thread a l'etape courante
+    double stepRate;                // Pas de la mise a jour de l'etape courante (mode synchrone, lu apres la barriere)
+    uint32_t nbSamples;             // Nombre d'echantillons de l'apprentissage en cours
+    const Dataset* dataset;         // Images de l'apprentissage en cours
+    const uint32_t* order;          // Rangs des images de l'apprentissage en cours, dans l'ordre (si specifies)
+    Report* report;                 // Suivi de l'apprentissage (perte, precision, debit), si specifie
+} Trainer;
+
+
+/** Creation de l'apprentissage parallele du reseau specifie, selon la configuration
+ *
+ */
+extern Trainer* TRAINER_create( Network* network, const Config* cfg );
+
+/** Apprentissage du reseau sur les images de rangs order[0..nbSamples-1] de l'ensemble specifie (les nbSamples
+ *  premieres images si order est nul)
+ *
+ *  Retourne le nombre d'echantillons effectivement appris (les images illisibles sont ignorees). Si un thread
+ *  ne peut pas etre lance, aucun echantillon n'est appris
+ */
+extern uint32_t TRAINER_run( Trainer* trainer, const Dataset* dataset, const uint32_t* order, uint32_t nbSamples );
+
+/** Destruction de l'apprentissage parallele
+ *
+ */
+extern void TRAINER_destroy( Trainer* trainer );
+
+#endif // _IA_TRAINER_H_
@@ -0,0 +1,109 @@
+#ifndef _IA_VALIDATOR_H_
+#define _IA_VALIDATOR_H_
+
+// System
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Local
+#include "ia/network.h"
+#include "ia/config.h"
+#include "ia/workspace.h"
+#include "ia/dataset.h"
+#include "ia/report.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: VALIDATOR
+// Description:
+//      Validation periodique du reseau en cours d'apprentissage, sur des images d'apprentissage mises de cote.
+//      La validation porte sur un instantane des poids (copie), classifie par un thread dedie : l'apprentissage
+//      continue pendant la validation, et n'est interrompu que le temps de la copie. Les poids de la meilleure
+//      validation sont conserves, et l'apprentissage peut etre arrete apres plusieurs validations sans
+//      amelioration (arret anticipe)
+//--------------------------------------------------------------------------------------------------------------
+
+/** Structure de donnees associee a la validation
+ *
+ */
+typedef struct
+{
+    Network* snapshot;              // Reseau valide, dont les poids sont ceux de l'instantane
+    Real* weights;                  // Poids et biais de l'instantane (toutes les couches, contigus)
+    Real* best;                     // Poids et biais de la meilleure validation
+    size_t size;                    // Nombre de reels de l'instantane
+    const Dataset* dataset;         // Images de validation
+    uint32_t first;                 // Rang de la premiere image de validation
+    uint32_t nbSamples;             // Nombre d'images de validation
+    uint32_t interval;              // Echantillons appris entre deux validations (0 : a la demande uniquement)
+    uint32_t patience;              // Validations sans amelioration avant l'arret (0 : pas d'arret anticipe)
+    const char* checkpointPath;     // Sauvegarde de la meilleure validation (si non nul)
+    Workspace* workspace;           // Espace de travail de la classification
+    Sample** batch;                 // Echantillons reutilises d'un lot a l'autre
+    Report* report;                 // Suivi de chaque validation (bilan uniquement)
+    uint64_t nbLearned;             // Nombre d'echantillons appris
+    uint64_t nextValidation;        // Nombre d'echantillons appris declenchant la prochaine validation
+    uint64_t position;              // Nombre d'echantillons appris a la date de l'instantane
+    uint32_t nbValidations;         // Nombre de validations effectuees
+    uint32_t nbSkipped;             // Instantanes ignores (validation precedente en cours)
+    uint32_t nbStale;               // Validations consecutives sans amelioration
+    uint32_t bestValidation;        // Numero de la meilleure validation (0 si aucune)
+    uint64_t bestPosition;          // Nombre d'echantillons appris lors de la meilleure validation
+    double bestAccuracy;            // Precision de la meilleure validation (en %)
+    double bestLoss;                // Perte moyenne de la meilleure validation
+    uint8_t pending;                // Instantane en attente ou en cours de validation
+    uint8_t exit;                   // Fin demandee au thread de validation
+    atomic_uchar stop;              // Arret anticipe de l'apprentissage demande
+    pthread_mutex_t mutex;          // Verrou de l'instantane
+    pthread_cond_t cond;            // Signalement d'un instantane, et de la fin de sa validation
+    pthread_t thread;               // Thread de validation
+    uint8_t running;                // Thread de validation lance
+} Validator;
+
+
+/** Creation de la validation du reseau specifie, sur les images de rangs first a first + nbSamples - 1
+ *
+ *  L'intervalle de validation, la patience et la sauvegarde de la meilleure validation sont ceux de la
+ *  configuration. Le thread de validation est lance, et attend le premier instantane. Retourne NULL si le
+ *  thread de validation n'a pas pu etre lance
+ */
+extern Validator* VALIDATOR_create( const Network* network, const Config* cfg, const Dataset* dataset,
+                                    uint32_t first, uint32_t nbSamples );
+
+/** Signale l'apprentissage de nbSamples echantillons supplementaires
+ *
+ *  Un instantane des poids est soumis a la validation si l'intervalle de validation est atteint. Les
+ *  poids ne doivent pas etre modifies pendant l'appel
+ */
+extern void VALIDATOR_step( Validator* validator, const Network* network, uint32_t nbSamples );
+
+/** Soumission immediate d'un instantane des poids du reseau
+ *
+ *  L'instantane est ignore si la validation precedente n'est pas terminee. Retourne 1 s'il a ete soumis
+ */
+extern int VALIDATOR_submit( Validator* validator, const Network* network );
+
+/** Indique si l'arret anticipe de l'apprentissage est demande
+ *
+ */
+extern int VALIDATOR_shouldStop( const Validator* validator );
+
+/** Fin de l'apprentissage : attente de la validation en cours, puis validation des derniers poids
+ *
+ *  Les derniers poids ne sont pas valides s'ils l'ont deja ete, ou si l'arret anticipe est demande
+ */
+extern void VALIDATOR_finish( Validator* validator, const Network* network );
+
+/** Restauration dans le reseau des poids de la meilleure validation
+ *
+ *  Retourne 0 si les poids ont ete restaures (aucune validation sinon)
+ */
+extern int VALIDATOR_restoreBest( const Validator* validator, Network* network );
+
+/** Destruction de la validation (arret du thread)
+ *
+ */
+extern void VALIDATOR_destroy( Validator* validator );
+
+#endif // _IA_VALIDATOR_H_
@@ -0,0 +1,48 @@
+#ifndef _IA_WORKSPACE_H_
+#define _IA_WORKSPACE_H_
+
+// System
+#include <stdint.h>
+
+// Local
+#include "ia/real.h"
+
+
+//--------------------------------------------------------------------------------------------------------------
+// Module: WORKSPACE
+// Description:
+//      Espace de travail pour la propagation d'un lot d'echantillons dans un reseau : sorties et gradients
+//      d'erreur de chaque couche pour chacun des echantillons du lot, et somme des gradients des poids
+//--------------------------------------------------------------------------------------------------------------
+
+// Pre-declarations
+struct Network;
+
+/** Structure de donnees associee a un espace de travail
+ *
+ *  Les tableaux sont indexes par le rang de la couche dans le reseau (la couche d'entree, de rang 0, n'a
+ *  que des sorties qui sont les entrees des echantillons du lot)
+ */
+typedef struct Workspace
+{
+    uint32_t capacity;          // Nombre maximal d'echantillons d'un lot
+    uint16_t nbLayers;          // Nombre de couches du reseau (couches d'entree et de sortie comprises)
+    Real** outputs;             // Sorties de chaque couche (capacity lignes de nbNeurons valeurs)
+    Real** errors;              // Gradients d'erreur de chaque couche (capacity lignes de nbNeurons valeurs)
+    Real** gradients;           // Sommes des gradients des poids de chaque couche (dimensions des poids)
+} Workspace;
+
+
+/** Creation d'un espace de travail pour le reseau specifie, et des lots de la taille specifiee
+ *
+ *  Un espace de travail d'exploitation (training nul) n'a que les sorties des couches : il permet a un thread
+ *  de propager des echantillons dans un reseau partage, sans modifier le reseau
+ */
+extern Workspace* WORKSPACE_create( const struct Network* network, uint32_t capacity, uint8_t training );
+
+/** Destruction d'un espace de travail
+ *
+ */
+extern void WORKSPACE_destroy( Workspace* workspace );
+
+#endif // _IA_WORKSPACE_H_
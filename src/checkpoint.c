@@ -0,0 +1,184 @@
+#include "ia/checkpoint.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Alignement des poids et biais dans le fichier
+#define CHECKPOINT_ALIGNMENT 64
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Position alignee suivant la position specifiee
+ *
+ */
+static uint64_t align( uint64_t position );
+
+/** Ecriture d'octets nuls jusqu'a la position specifiee du fichier
+ *
+ */
+static void writePadding( FILE* file, uint64_t position, uint64_t aligned );
+
+/** Indique si count reels, a partir de la position offset, tiennent dans un fichier de size octets
+ *
+ *  La place restante est calculee par soustraction (pas de debordement avec un en-tete forge)
+ */
+static int fits( uint64_t offset, uint64_t count, uint64_t size );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+int CHECKPOINT_save( const Network* network, const char* fileName )
+{
+    // Creation du fichier
+    FILE* file = fopen( fileName, "wb" );
+    if( file == NULL )
+    {
+        fprintf( stderr, "ERREUR - Impossible de creer le point de sauvegarde : %s\n", fileName );
+        return( 1 );
+    }
+
+    // Construction de l'en-tete : topologie, parametres, et positions des poids et biais de chaque couche
+    CheckpointHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, CHECKPOINT_MAGIC, 4 );
+    header.version = CHECKPOINT_VERSION;
+    header.realSize = sizeof( Real );
+    header.nbLayers = network->nbInternals + 2;
+    header.learningRate = network->learningRate;
+    header.lambda = network->lambda;
+    header.batchSize = network->batchSize;
+    uint64_t position = align( sizeof( header ) );
+    for( const Layer* layer = network->input; layer != NULL; layer = layer->next )
+    {
+        header.sizes[layer->index] = layer->nbNeurons;
+        if( layer->weights == NULL ) continue;
+        header.weightsOffsets[layer->index] = position;
+        position = align( position + (uint64_t)layer->nbNeurons * layer->nbInputs * sizeof( Real ) );
+        header.biasOffsets[layer->index] = position;
+        position = align( position + (uint64_t)layer->nbNeurons * sizeof( Real ) );
+    }
+    fwrite( &header, sizeof( header ), 1, file );
+
+    // Ecriture des poids et biais de chaque couche
+    int status = 0;
+    position = sizeof( header );
+    for( const Layer* layer = network->input; layer != NULL && status == 0; layer = layer->next )
+    {
+        if( layer->weights == NULL ) continue;
+        const size_t nbWeights = (size_t)layer->nbNeurons * layer->nbInputs;
+        writePadding( file, position, header.weightsOffsets[layer->index] );
+        if( fwrite( layer->weights, sizeof( Real ), nbWeights, file ) != nbWeights ) status = 2;
+        writePadding( file, header.weightsOffsets[layer->index] + nbWeights * sizeof( Real ),
+                      header.biasOffsets[layer->index] );
+        if( fwrite( layer->bias, sizeof( Real ), layer->nbNeurons, file ) != layer->nbNeurons ) status = 2;
+        position = header.biasOffsets[layer->index] + layer->nbNeurons * sizeof( Real );
+    }
+
+    // Fermeture du fichier
+    if( fclose( file ) != 0 ) status = 2;
+    if( status != 0 ) fprintf( stderr, "ERREUR - Echec d'ecriture du point de sauvegarde : %s\n", fileName );
+
+    return( status );
+}
+
+
+Network* CHECKPOINT_load( const char* fileName )
+{
+    // Ouverture du fichier, et recuperation de sa taille
+    const int fd = open( fileName, O_RDONLY );
+    struct stat info;
+    if( fd < 0 || fstat( fd, &info ) != 0 || (size_t)info.st_size < sizeof( CheckpointHeader ) )
+    {
+        fprintf( stderr, "ERREUR - Impossible d'ouvrir le point de sauvegarde : %s\n", fileName );
+        if( fd >= 0 ) close( fd );
+        return( NULL );
+    }
+
+    // Projection en copie privee : pages partagees tant que les poids ne sont pas modifies
+    const size_t size = info.st_size;
+    uint8_t* data = (uint8_t*)mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if( data == MAP_FAILED )
+    {
+        fprintf( stderr, "ERREUR - Impossible de projeter le point de sauvegarde en memoire : %s\n", fileName );
+        return( NULL );
+    }
+
+    // Verification de l'en-tete
+    const CheckpointHeader* header = (const CheckpointHeader*)data;
+    int valid = ( memcmp( header->magic, CHECKPOINT_MAGIC, 4 ) == 0 && header->version == CHECKPOINT_VERSION &&
+                  header->nbLayers >= 2 && header->nbLayers <= CHECKPOINT_MAX_LAYERS && header->sizes[0] > 0 );
+    if( valid && header->realSize != sizeof( Real ) )
+    {
+        fprintf( stderr, "ERREUR - Point de sauvegarde en reels de %u octets (%zu attendus) : %s\n",
+                 header->realSize, sizeof( Real ), fileName );
+        munmap( data, size );
+        return( NULL );
+    }
+
+    // Configuration correspondant a la topologie, et positions des poids et biais de chaque couche
+    Config* cfg = CONFIG_create();
+    Real* weights[CHECKPOINT_MAX_LAYERS] = { NULL };
+    Real* bias[CHECKPOINT_MAX_LAYERS] = { NULL };
+    for( uint32_t i = 1; valid && i < header->nbLayers; ++i )
+    {
+        const uint64_t nbWeights = (uint64_t)header->sizes[i] * header->sizes[i - 1];
+        if( header->sizes[i] == 0 ||
+            header->weightsOffsets[i] % CHECKPOINT_ALIGNMENT != 0 ||
+            header->biasOffsets[i] % CHECKPOINT_ALIGNMENT != 0 ||
+            !fits( header->weightsOffsets[i], nbWeights, size ) ||
+            !fits( header->biasOffsets[i], header->sizes[i], size ) )
+        {
+            valid = 0;
+            break;
+        }
+        weights[i] = (Real*)( data + header->weightsOffsets[i] );
+        bias[i] = (Real*)( data + header->biasOffsets[i] );
+        if( i + 1 < header->nbLayers ) cfg->internalSize[cfg->nbLayers++] = header->sizes[i];
+    }
+    if( !valid )
+    {
+        fprintf( stderr, "ERREUR - Point de sauvegarde invalide : %s\n", fileName );
+        CONFIG_destroy( cfg );
+        munmap( data, size );
+        return( NULL );
+    }
+    cfg->inputSize = header->sizes[0];
+    cfg->outputSize = header->sizes[header->nbLayers - 1];
+    cfg->learningRate = header->learningRate;
+    cfg->lambda = header->lambda;
+    cfg->batchSize = header->batchSize;
+
+    // Creation du reseau sur les poids projetes (la projection est liberee avec le reseau)
+    Network* network = NETWORK_createMapped( cfg, weights, bias, data, size );
+    CONFIG_destroy( cfg );
+
+    return( network );
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static uint64_t align( uint64_t position )
+{
+    return( ( ( position + CHECKPOINT_ALIGNMENT - 1 ) / CHECKPOINT_ALIGNMENT ) * CHECKPOINT_ALIGNMENT );
+}
+
+
+static void writePadding( FILE* file, uint64_t position, uint64_t aligned )
+{
+    static const uint8_t zeros[CHECKPOINT_ALIGNMENT] = { 0 };
+    fwrite( zeros, 1, aligned - position, file );
+}
+
+
+static int fits( uint64_t offset, uint64_t count, uint64_t size )
+{
+    return( offset <= size && count <= ( size - offset ) / sizeof( Real ) );
+}
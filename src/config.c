@@ -7,6 +7,10 @@
 #include <errno.h>
 #include <math.h>
 
+// Local
+#include "ia/ingest.h"
+#include "ia/random.h"
+
 // Taille de buffer
 #define BUFF_SIZE 256
 
@@ -27,6 +31,16 @@ Config* CONFIG_create()
     Config* config= (Config*)malloc( sizeof( Config ) );
     memset( config, 0, sizeof( Config ) );
 
+    // Valeurs par defaut
+    config->nbThreads = 1;
+    config->nbEpochs = 1;
+    config->momentum = 0.9;
+    config->beta2 = 0.999;
+    config->epsilon = 1e-8;
+    config->reportInterval = 1000;
+    config->ingest = INGEST_URING;
+    config->seed = RANDOM_DEFAULT_SEED;
+
     return( config );
 }
 
@@ -108,15 +122,100 @@ static int extractConfigValue( Config* config, const char* line )
     // Extraction de la valeur
     ptr = strtok( NULL, " \t" );
     if( ptr == NULL ) return( 2 );
+    const char* text = ptr;
+
+    // Verification fin de ligne
+    if( strtok( NULL, " \t" ) != NULL ) return( 4 );
+
+    // Mots-cles dont la valeur est une chaine de caracteres
+    if( strcmp( key, "parallel" ) == 0 )
+    {
+        // Mode de combinaison des gradients en apprentissage parallele
+        if( strcmp( text, "sync" ) == 0 ) config->hogwild = 0;
+        else if( strcmp( text, "hogwild" ) == 0 ) config->hogwild = 1;
+        else return( 3 );
+        return( 0 );
+    }
+    else if( strcmp( key, "optimizer" ) == 0 )
+    {
+        // Methode de mise a jour des poids
+        if( strcmp( text, "sgd" ) == 0 ) config->optimizer = OPTIMIZER_SGD;
+        else if( strcmp( text, "momentum" ) == 0 ) config->optimizer = OPTIMIZER_MOMENTUM;
+        else if( strcmp( text, "nesterov" ) == 0 ) config->optimizer = OPTIMIZER_NESTEROV;
+        else if( strcmp( text, "adam" ) == 0 ) config->optimizer = OPTIMIZER_ADAM;
+        else return( 3 );
+        return( 0 );
+    }
+    else if( strcmp( key, "ingest" ) == 0 )
+    {
+        // Lecture des images d'un repertoire : sequentielle, par un groupe de threads, ou par io_uring
+        if( strcmp( text, "none" ) == 0 ) config->ingest = INGEST_NONE;
+        else if( strcmp( text, "threads" ) == 0 ) config->ingest = INGEST_THREADS;
+        else if( strcmp( text, "uring" ) == 0 ) config->ingest = INGEST_URING;
+        else return( 3 );
+        return( 0 );
+    }
+    else if( strcmp( key, "activation" ) == 0 )
+    {
+        // Calcul des fonctions d'activation (sigmoide et SOFTMAX) : exact (libm) ou approche (vectorise)
+        if( strcmp( text, "exact" ) == 0 ) config->fastActivation = 0;
+        else if( strcmp( text, "fast" ) == 0 ) config->fastActivation = 1;
+        else return( 3 );
+        return( 0 );
+    }
+    else if( strcmp( key, "keep" ) == 0 )
+    {
+        // Reseau conserve a la fin de l'apprentissage : dernier, ou meilleur en validation
+        if( strcmp( text, "last" ) == 0 ) config->keepBest = 0;
+        else if( strcmp( text, "best" ) == 0 ) config->keepBest = 1;
+        else return( 3 );
+        return( 0 );
+    }
+    else if( strcmp( key, "format" ) == 0 )
+    {
+        // Format des statistiques d'apprentissage et de test
+        if( strcmp( text, "text" ) == 0 ) config->reportJson = 0;
+        else if( strcmp( text, "json" ) == 0 ) config->reportJson = 1;
+        else return( 3 );
+        return( 0 );
+    }
+    else if( strcmp( key, "seed" ) == 0 )
+    {
+        // Graine des tirages aleatoires (entier de 64 bits, decimal ou hexadecimal)
+        char* end = NULL;
+        errno = 0;
+        const unsigned long long seed = strtoull( text, &end, 0 );
+        if( end == text || *end != '\0' || errno != 0 ) return( 3 );
+        config->seed = seed;
+        return( 0 );
+    }
+    else if( strcmp( key, "training" ) == 0 )
+    {
+        // Images d'apprentissage
+        if( strlen( text ) >= MAX_PATH ) return( 3 );
+        strcpy( config->trainingPath, text );
+        return( 0 );
+    }
+    else if( strcmp( key, "testing" ) == 0 )
+    {
+        // Images de test
+        if( strlen( text ) >= MAX_PATH ) return( 3 );
+        strcpy( config->testingPath, text );
+        return( 0 );
+    }
+    else if( strcmp( key, "checkpoint" ) == 0 )
+    {
+        // Point de sauvegarde du reseau entraine
+        if( strlen( text ) >= MAX_PATH ) return( 3 );
+        strcpy( config->checkpointPath, text );
+        return( 0 );
+    }
 
     // Conversion de la valeur en reel
     char* endptr = ptr;
-    const double value = strtod( ptr, &endptr );
+    const double value = strtod( text, &endptr );
     if( *endptr != '\0' ) return( 3 );
 
-    // Verification fin de ligne
-    if( strtok( NULL, " \t" ) != NULL ) return( 4 );
-
     // En fonction du mot-cle
     if( strcmp( key, "input" ) == 0 )
     {
@@ -143,6 +242,79 @@ static int extractConfigValue( Config* config, const char* line )
         // Parametre lambda de la sigmoide
         config->lambda = value;
     }
+    else if( strcmp( key, "momentum" ) == 0 )
+    {
+        // Coefficient du moment (ou beta1, coefficient de la moyenne des gradients pour Adam)
+        if( value < 0.0 || value >= 1.0 ) return( 3 );
+        config->momentum = value;
+    }
+    else if( strcmp( key, "beta2" ) == 0 )
+    {
+        // Coefficient de la moyenne des carres des gradients (Adam)
+        if( value < 0.0 || value >= 1.0 ) return( 3 );
+        config->beta2 = value;
+    }
+    else if( strcmp( key, "epsilon" ) == 0 )
+    {
+        // Terme ajoute a la racine de la moyenne des carres des gradients (Adam)
+        config->epsilon = value;
+    }
+    else if( strcmp( key, "batch" ) == 0 )
+    {
+        // Taille des lots d'echantillons (apprentissage par mini-lots)
+        config->batchSize = (uint32_t)value;
+    }
+    else if( strcmp( key, "epochs" ) == 0 )
+    {
+        // Nombre de passes (epoques) sur les images d'apprentissage
+        if( value < 1.0 ) return( 3 );
+        config->nbEpochs = (uint32_t)value;
+    }
+    else if( strcmp( key, "shuffle" ) == 0 )
+    {
+        // Ordre des images d'apprentissage melange a chaque epoque (0 ou 1)
+        config->shuffle = ( value != 0.0 );
+    }
+    else if( strcmp( key, "validation" ) == 0 )
+    {
+        // Nombre d'images d'apprentissage (les dernieres) mises de cote pour la validation
+        config->nbValidation = (uint32_t)value;
+    }
+    else if( strcmp( key, "validate" ) == 0 )
+    {
+        // Nombre d'echantillons appris entre deux validations (0 pour valider a la fin de chaque epoque)
+        config->validationInterval = (uint32_t)value;
+    }
+    else if( strcmp( key, "patience" ) == 0 )
+    {
+        // Nombre de validations sans amelioration avant l'arret de l'apprentissage (0 : pas d'arret anticipe)
+        config->patience = (uint32_t)value;
+    }
+    else if( strcmp( key, "threads" ) == 0 )
+    {
+        // Nombre de threads d'apprentissage (0 pour utiliser tous les coeurs)
+        config->nbThreads = (uint32_t)value;
+    }
+    else if( strcmp( key, "prefetch" ) == 0 )
+    {
+        // Profondeur de la file de prechargement asynchrone des images (0 pour charger a la demande)
+        config->prefetch = (uint32_t)value;
+    }
+    else if( strcmp( key, "quantize" ) == 0 )
+    {
+        // Test complementaire du reseau quantifie sur 8 bits (0 ou 1)
+        config->quantize = ( value != 0.0 );
+    }
+    else if( strcmp( key, "verbosity" ) == 0 )
+    {
+        // Niveau de detail des traces (0 : statistiques, 1 : chaque echantillon, 2 : erreurs en sortie)
+        config->verbosity = (uint8_t)value;
+    }
+    else if( strcmp( key, "report" ) == 0 )
+    {
+        // Nombre d'echantillons entre deux emissions des statistiques (0 pour le bilan final uniquement)
+        config->reportInterval = (uint32_t)value;
+    }
     else
     {
         // Mot-cle inconnu
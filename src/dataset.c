@@ -0,0 +1,550 @@
+#include "ia/dataset.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Identifiants des fichiers IDX (grand-boutiste) : octets nuls, type (0x08 = uint8), nombre de dimensions
+#define IDX_IMAGES_MAGIC 0x00000803
+#define IDX_LABELS_MAGIC 0x00000801
+
+// Alignement des sections d'un fichier compact
+#define PACK_ALIGNMENT 64
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Contexte du chargement en memoire d'un repertoire
+ *
+ */
+typedef struct
+{
+    const Dataset* dataset;         // Repertoire charge
+    uint8_t* pixels;                // Pixels bruts des images
+    uint32_t* maxValues;            // Valeurs maximales des pixels de chaque image
+} LoadContext;
+
+/** Decodage d'une image PGM lue en memoire, a son rang dans les pixels du chargement (voir module INGEST)
+ *
+ */
+static int decodeImage( void* context, uint32_t index, const uint8_t* data, size_t size );
+
+/** Extrait l'etiquette (chiffre) du nom de fichier specifie, au format "image-<num>-label-<digit>.pgm"
+ *
+ *  Retourne -1 si le nom ne respecte pas ce format
+ */
+static int16_t parseLabel( const char* fileName );
+
+/** Projection en memoire (lecture seule) du fichier specifie
+ *
+ *  Retourne NULL en cas d'echec
+ */
+static void* mapFile( const char* fileName, size_t* size );
+
+/** Lecture d'un entier 32 bits grand-boutiste (format IDX)
+ *
+ */
+static uint32_t readBigEndian( const uint8_t* data );
+
+/** Position alignee (sur PACK_ALIGNMENT octets) suivant la position specifiee
+ *
+ */
+static uint64_t align( uint64_t position );
+
+/** Ecriture d'octets nuls jusqu'a la position alignee suivante du fichier
+ *
+ */
+static uint64_t writePadding( FILE* file, uint64_t position );
+
+/** Verification des etiquettes : chacune doit etre un chiffre (0 a 9)
+ *
+ *  Retourne 0 si toutes les etiquettes sont valides
+ */
+static int checkLabels( const uint8_t* labels, uint32_t nbSamples );
+
+/** Indique si count elements de elementSize octets, a partir de la position offset, tiennent dans un fichier
+ *  de size octets
+ *
+ *  La place restante est calculee par soustraction : les valeurs d'un en-tete forge ne peuvent pas faire
+ *  deborder le calcul
+ */
+static int fits( uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Dataset* DATASET_open( const char* path )
+{
+    // Si le chemin est un repertoire
+    struct stat info;
+    if( strchr( path, ',' ) == NULL && stat( path, &info ) == 0 && S_ISDIR( info.st_mode ) )
+    {
+        return( DATASET_openDirectory( path ) );
+    }
+
+    // Deux fichiers separes par une virgule : images et etiquettes IDX
+    char imagesFile[256];
+    char labelsFile[256];
+    const char* comma = strchr( path, ',' );
+    if( comma != NULL )
+    {
+        snprintf( imagesFile, sizeof( imagesFile ), "%.*s", (int)( comma - path ), path );
+        snprintf( labelsFile, sizeof( labelsFile ), "%s", comma + 1 );
+        return( DATASET_openIdx( imagesFile, labelsFile ) );
+    }
+
+    // Lecture de l'identifiant du fichier
+    uint8_t magic[4] = { 0 };
+    FILE* file = fopen( path, "rb" );
+    if( file == NULL )
+    {
+        fprintf( stderr, "ERREUR - Impossible d'ouvrir l'ensemble d'images : %s\n", path );
+        return( NULL );
+    }
+    const size_t nbRead = fread( magic, 1, sizeof( magic ), file );
+    fclose( file );
+
+    // Fichier compact
+    if( nbRead == sizeof( magic ) && memcmp( magic, DATASET_PACK_MAGIC, 4 ) == 0 )
+    {
+        return( DATASET_openPacked( path ) );
+    }
+
+    // Fichier d'images IDX : le fichier d'etiquettes est deduit du nom du fichier d'images
+    if( nbRead == sizeof( magic ) && readBigEndian( magic ) == IDX_IMAGES_MAGIC )
+    {
+        snprintf( imagesFile, sizeof( imagesFile ), "%s", path );
+        snprintf( labelsFile, sizeof( labelsFile ), "%s", path );
+        char* ptr = strstr( labelsFile, "images" );
+        char* ptrIdx = strstr( labelsFile, "idx3" );
+        if( ptr == NULL || ptrIdx == NULL )
+        {
+            fprintf( stderr, "ERREUR - Impossible de deduire le fichier d'etiquettes de : %s\n", path );
+            return( NULL );
+        }
+        memcpy( ptr, "labels", 6 );
+        memcpy( ptrIdx, "idx1", 4 );
+        return( DATASET_openIdx( imagesFile, labelsFile ) );
+    }
+
+    fprintf( stderr, "ERREUR - Format d'ensemble d'images inconnu : %s\n", path );
+    return( NULL );
+}
+
+
+Dataset* DATASET_openDirectory( const char* imageFolder )
+{
+    // Ouverture du repertoire qui contient les images
+    DIR* dir = opendir( imageFolder );
+    if( dir == NULL )
+    {
+        fprintf( stderr, "ERREUR - Impossible d'ouvror le répertoire %s\n", imageFolder );
+        return( NULL );
+    }
+
+    // Allocation de la struture de donnees
+    Dataset* dataset = (Dataset*)malloc( sizeof( Dataset ) );
+    memset( dataset, 0, sizeof( Dataset ) );
+    dataset->imageSize = SAMPLE_IMAGE_SIZE;
+
+    // Pour chaque entree du repertoire
+    uint32_t capacity = 1024;
+    uint8_t* labels = (uint8_t*)malloc( capacity * sizeof( uint8_t ) );
+    dataset->files = (char**)malloc( capacity * sizeof( char* ) );
+    struct dirent *entry = NULL;
+    while( ( entry = readdir( dir ) ) != NULL )
+    {
+        // On ignore tout fichier qui ne commence pas par "image-"
+        const char* fileName = entry->d_name;
+        if( strncmp( fileName, "image-", 6 ) != 0 ) continue;
+
+        // On recupere le chiffre associe a l'image
+        const int16_t digit = parseLabel( fileName );
+        if( digit < 0 || digit > 9 )
+        {
+            fprintf( stderr, "ERREUR - Etiquette d'image incorrecte: %s\n", fileName );
+            continue;
+        }
+
+        // Agrandissement des tableaux si necessaire
+        if( dataset->nbSamples == capacity )
+        {
+            capacity *= 2;
+            labels = (uint8_t*)realloc( labels, capacity * sizeof( uint8_t ) );
+            dataset->files = (char**)realloc( dataset->files, capacity * sizeof( char* ) );
+        }
+
+        // Constrution du chemin complet
+        char filePath[512];
+        snprintf( filePath, sizeof( filePath ), "%s/%s", imageFolder, fileName );
+        dataset->files[dataset->nbSamples] = strdup( filePath );
+        labels[dataset->nbSamples++] = (uint8_t)digit;
+    }
+    dataset->labels = labels;
+
+    // Fermeture du repertoire
+    closedir( dir );
+
+    return( dataset );
+}
+
+
+Dataset* DATASET_openPacked( const char* fileName )
+{
+    // Projection du fichier en memoire
+    size_t size = 0;
+    uint8_t* data = (uint8_t*)mapFile( fileName, &size );
+    if( data == NULL ) return( NULL );
+
+    // Verification de l'en-tete (dont les champs ne sont lus que si le fichier le contient entierement), puis
+    // des positions et tailles des etiquettes et des pixels, et enfin des etiquettes elles-memes
+    const DatasetHeader* header = (const DatasetHeader*)data;
+    const uint64_t imageSize = ( size >= sizeof( DatasetHeader ) ? (uint64_t)header->width * header->height : 0 );
+    if( size < sizeof( DatasetHeader ) || memcmp( header->magic, DATASET_PACK_MAGIC, 4 ) != 0 ||
+        header->version != DATASET_PACK_VERSION || imageSize == 0 || imageSize > UINT32_MAX ||
+        !fits( header->labelsOffset, header->nbSamples, 1, size ) ||
+        !fits( header->pixelsOffset, header->nbSamples, imageSize, size ) ||
+        header->maxValue == 0 || checkLabels( data + header->labelsOffset, header->nbSamples ) != 0 )
+    {
+        fprintf( stderr, "ERREUR - Fichier compact invalide : %s\n", fileName );
+        munmap( data, size );
+        return( NULL );
+    }
+
+    // Allocation de la struture de donnees
+    Dataset* dataset = (Dataset*)malloc( sizeof( Dataset ) );
+    memset( dataset, 0, sizeof( Dataset ) );
+    dataset->mappings[0] = data;
+    dataset->mappingSizes[0] = size;
+
+    // Les etiquettes et pixels sont directement lus dans la projection
+    dataset->nbSamples = header->nbSamples;
+    dataset->imageSize = (uint32_t)imageSize;
+    dataset->maxValue = header->maxValue;
+    dataset->labels = data + header->labelsOffset;
+    dataset->pixels = data + header->pixelsOffset;
+
+    return( dataset );
+}
+
+
+Dataset* DATASET_openIdx( const char* imagesFile, const char* labelsFile )
+{
+    // Projection des deux fichiers en memoire
+    size_t imagesSize = 0, labelsSize = 0;
+    uint8_t* images = (uint8_t*)mapFile( imagesFile, &imagesSize );
+    uint8_t* labels = (uint8_t*)mapFile( labelsFile, &labelsSize );
+    if( images == NULL || labels == NULL )
+    {
+        if( images ) munmap( images, imagesSize );
+        if( labels ) munmap( labels, labelsSize );
+        return( NULL );
+    }
+
+    // Verification des en-tetes : images (identifiant, nombre, lignes, colonnes) et etiquettes (identifiant,
+    // nombre), puis des etiquettes elles-memes (chiffres)
+    const uint32_t nbSamples = ( imagesSize >= 16 ? readBigEndian( images + 4 ) : 0 );
+    const uint64_t imageSize = ( imagesSize >= 16 ?
+                                 (uint64_t)readBigEndian( images + 8 ) * readBigEndian( images + 12 ) : 0 );
+    if( imagesSize < 16 || labelsSize < 8 ||
+        readBigEndian( images ) != IDX_IMAGES_MAGIC || readBigEndian( labels ) != IDX_LABELS_MAGIC ||
+        readBigEndian( labels + 4 ) != nbSamples || imageSize == 0 || imageSize > UINT32_MAX ||
+        !fits( 16, nbSamples, imageSize, imagesSize ) || !fits( 8, nbSamples, 1, labelsSize ) ||
+        checkLabels( labels + 8, nbSamples ) != 0 )
+    {
+        fprintf( stderr, "ERREUR - Fichiers IDX invalides : %s, %s\n", imagesFile, labelsFile );
+        munmap( images, imagesSize );
+        munmap( labels, labelsSize );
+        return( NULL );
+    }
+
+    // Allocation de la struture de donnees
+    Dataset* dataset = (Dataset*)malloc( sizeof( Dataset ) );
+    memset( dataset, 0, sizeof( Dataset ) );
+    dataset->mappings[0] = images;
+    dataset->mappingSizes[0] = imagesSize;
+    dataset->mappings[1] = labels;
+    dataset->mappingSizes[1] = labelsSize;
+
+    // Les etiquettes et pixels sont directement lus dans les projections
+    dataset->nbSamples = nbSamples;
+    dataset->imageSize = (uint32_t)imageSize;
+    dataset->maxValue = 255;
+    dataset->labels = labels + 8;
+    dataset->pixels = images + 16;
+
+    return( dataset );
+}
+
+
+int DATASET_load( Dataset* dataset, uint8_t backend, IngestStats* stats )
+{
+    // Images deja en memoire (fichier compact ou IDX, ou repertoire deja charge)
+    if( dataset->pixels != NULL ) return( 0 );
+
+    // Lecture et decodage de chaque image du repertoire, a son rang dans un tableau unique de pixels
+    uint8_t* pixels = (uint8_t*)malloc( (size_t)dataset->nbSamples * dataset->imageSize );
+    uint32_t* maxValues = (uint32_t*)malloc( dataset->nbSamples * sizeof( uint32_t ) );
+    LoadContext context = { dataset, pixels, maxValues };
+    if( INGEST_readFiles( backend, dataset->files, dataset->nbSamples, SAMPLE_PGM_MAX_SIZE, decodeImage, &context,
+                          stats ) != 0 )
+    {
+        free( pixels );
+        free( maxValues );
+        return( 1 );
+    }
+    dataset->pixels = pixels;
+    dataset->maxValues = maxValues;
+
+    return( 0 );
+}
+
+
+void DATASET_shuffle( uint32_t* order, uint32_t count, Random* random )
+{
+    // Fisher-Yates : chaque rang est echange avec un rang tire parmi ceux qui le precedent (et lui-meme)
+    for( uint32_t i = count; i > 1; --i )
+    {
+        const uint32_t j = RANDOM_below( random, i );
+        const uint32_t swap = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = swap;
+    }
+}
+
+
+int DATASET_pack( const Dataset* dataset, const char* fileName )
+{
+    // Creation du fichier
+    FILE* file = fopen( fileName, "wb" );
+    if( file == NULL )
+    {
+        fprintf( stderr, "ERREUR - Impossible de creer le fichier : %s\n", fileName );
+        return( 1 );
+    }
+
+    // Ecriture de l'en-tete (les pixels d'un repertoire sont normalises sur 0..255)
+    DatasetHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, DATASET_PACK_MAGIC, 4 );
+    header.version = DATASET_PACK_VERSION;
+    header.nbSamples = dataset->nbSamples;
+    header.width = ( dataset->imageSize == SAMPLE_IMAGE_SIZE ? SAMPLE_IMAGE_WIDTH : dataset->imageSize );
+    header.height = dataset->imageSize / header.width;
+    header.maxValue = ( dataset->files == NULL ? dataset->maxValue : 255 );
+    header.labelsOffset = align( sizeof( header ) );
+    header.pixelsOffset = align( header.labelsOffset + header.nbSamples );
+    fwrite( &header, sizeof( header ), 1, file );
+
+    // Ecriture des etiquettes
+    uint64_t position = writePadding( file, sizeof( header ) );
+    fwrite( dataset->labels, 1, dataset->nbSamples, file );
+    writePadding( file, position + dataset->nbSamples );
+
+    // Ecriture des pixels de chaque image
+    int status = 0;
+    uint8_t* pixels = (uint8_t*)malloc( dataset->imageSize );
+    for( uint32_t i = 0; i < dataset->nbSamples && status == 0; ++i )
+    {
+        if( dataset->pixels != NULL && dataset->maxValues == NULL )
+        {
+            memcpy( pixels, dataset->pixels + (size_t)i * dataset->imageSize, dataset->imageSize );
+        }
+        else
+        {
+            // Lecture (ou copie, si le repertoire est charge) de l'image, et normalisation des pixels sur 0..255
+            uint32_t maxValue = 0;
+            if( dataset->maxValues != NULL )
+            {
+                memcpy( pixels, dataset->pixels + (size_t)i * dataset->imageSize, dataset->imageSize );
+                maxValue = dataset->maxValues[i];
+            }
+            else if( SAMPLE_readImage( dataset->files[i], pixels, &maxValue ) != 0 )
+            {
+                status = 2;
+                break;
+            }
+            if( maxValue == 0 )
+            {
+                status = 2;
+                break;
+            }
+            if( maxValue != 255 )
+            {
+                for( uint32_t j = 0; j < dataset->imageSize; ++j ) pixels[j] = (uint8_t)( pixels[j] * 255u / maxValue );
+            }
+        }
+        if( fwrite( pixels, dataset->imageSize, 1, file ) != 1 ) status = 3;
+    }
+    free( pixels );
+
+    // Fermeture du fichier
+    if( fclose( file ) != 0 && status == 0 ) status = 3;
+    if( status != 0 ) fprintf( stderr, "ERREUR - Echec d'ecriture du fichier compact : %s\n", fileName );
+
+    return( status );
+}
+
+
+const char* DATASET_getName( const Dataset* dataset, uint32_t index )
+{
+    // Seules les images d'un repertoire ont un nom
+    if( dataset->files == NULL ) return( NULL );
+
+    const char* ptr = strrchr( dataset->files[index], '/' );
+    return( ptr != NULL ? ptr + 1 : dataset->files[index] );
+}
+
+
+Sample* DATASET_getSample( const Dataset* dataset, uint32_t index, uint8_t labelled )
+{
+    // Creation d'un echantillon, et chargement de l'image
+    Sample* sample = SAMPLE_createEmpty( dataset->imageSize, SAMPLE_OUTPUT_SIZE );
+    if( DATASET_loadSample( dataset, index, labelled, sample ) != 0 )
+    {
+        SAMPLE_destroy( sample );
+        return( NULL );
+    }
+
+    return( sample );
+}
+
+
+int DATASET_loadSample( const Dataset* dataset, uint32_t index, uint8_t labelled, Sample* sample )
+{
+    // Chiffre associe a l'echantillon (seulement s'il est etiquete)
+    const int16_t digit = ( labelled ? dataset->labels[index] : -1 );
+
+    // Lecture du fichier image (repertoire), ou pixels directement lus en memoire
+    if( dataset->pixels == NULL )
+    {
+        return( SAMPLE_load( sample, dataset->files[index], digit ) );
+    }
+    SAMPLE_setPixels( sample, dataset->pixels + (size_t)index * dataset->imageSize, dataset->imageSize,
+                      ( dataset->maxValues != NULL ? dataset->maxValues[index] : dataset->maxValue ), digit );
+
+    return( 0 );
+}
+
+
+void DATASET_destroy( Dataset* dataset )
+{
+    // Si valide
+    if( dataset != NULL )
+    {
+        // Liberation de la liste des fichiers, des etiquettes, et des images chargees d'un repertoire
+        if( dataset->files != NULL )
+        {
+            for( uint32_t i = 0; i < dataset->nbSamples; ++i ) free( dataset->files[i] );
+            free( dataset->files );
+            free( (uint8_t*)dataset->labels );
+            free( (uint8_t*)dataset->pixels );
+            free( (uint32_t*)dataset->maxValues );
+        }
+
+        // Liberation des projections
+        for( uint32_t i = 0; i < 2; ++i )
+        {
+            if( dataset->mappings[i] != NULL ) munmap( dataset->mappings[i], dataset->mappingSizes[i] );
+        }
+
+        // Liberation memoire
+        free( dataset );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static int16_t parseLabel( const char* fileName )
+{
+    // On veut extraire le segment entre le dernier '-' et le '.'
+    const char* ptrDash = strrchr( fileName, '-' );
+    const char* ptrDot = strchr( fileName, '.' );
+    if( ptrDash == NULL || ptrDot == NULL || ptrDot - ptrDash != 2 )
+    {
+        fprintf( stderr, "ERREUR - Format du nom de fichier image incorrect: %s\n", fileName );
+        return( -1 );
+    }
+    if( ptrDash[1] < '0' || ptrDash[1] > '9' ) return( -1 );
+
+    return( (int16_t)( ptrDash[1] - '0' ) );
+}
+
+
+static void* mapFile( const char* fileName, size_t* size )
+{
+    // Ouverture du fichier, et recuperation de sa taille
+    const int fd = open( fileName, O_RDONLY );
+    struct stat info;
+    if( fd < 0 || fstat( fd, &info ) != 0 || info.st_size == 0 )
+    {
+        fprintf( stderr, "ERREUR - Impossible d'ouvrir le fichier : %s\n", fileName );
+        if( fd >= 0 ) close( fd );
+        return( NULL );
+    }
+
+    // Projection (partagee, en lecture seule) : les pages sont partagees avec les autres processus
+    void* data = mmap( NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( data == MAP_FAILED )
+    {
+        fprintf( stderr, "ERREUR - Impossible de projeter le fichier en memoire : %s\n", fileName );
+        return( NULL );
+    }
+    *size = info.st_size;
+
+    return( data );
+}
+
+
+static uint32_t readBigEndian( const uint8_t* data )
+{
+    return( ( (uint32_t)data[0] << 24 ) | ( (uint32_t)data[1] << 16 ) | ( (uint32_t)data[2] << 8 ) | data[3] );
+}
+
+
+static uint64_t align( uint64_t position )
+{
+    return( ( ( position + PACK_ALIGNMENT - 1 ) / PACK_ALIGNMENT ) * PACK_ALIGNMENT );
+}
+
+
+static uint64_t writePadding( FILE* file, uint64_t position )
+{
+    static const uint8_t zeros[PACK_ALIGNMENT] = { 0 };
+    const uint64_t aligned = align( position );
+    fwrite( zeros, 1, aligned - position, file );
+
+    return( aligned );
+}
+
+
+static int checkLabels( const uint8_t* labels, uint32_t nbSamples )
+{
+    for( uint32_t i = 0; i < nbSamples; ++i )
+    {
+        if( labels[i] >= SAMPLE_OUTPUT_SIZE ) return( 1 );
+    }
+
+    return( 0 );
+}
+
+
+static int fits( uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size )
+{
+    return( offset <= size && count <= ( size - offset ) / elementSize );
+}
+
+
+static int decodeImage( void* context, uint32_t index, const uint8_t* data, size_t size )
+{
+    LoadContext* load = (LoadContext*)context;
+    return( SAMPLE_parseImage( load->dataset->files[index], data, size,
+                               load->pixels + (size_t)index * load->dataset->imageSize, &load->maxValues[index] ) );
+}
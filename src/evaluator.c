@@ -0,0 +1,223 @@
+#include "ia/evaluator.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// Nombre d'echantillons propages ensemble par un thread
+#define BATCH_SIZE 16
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Contexte d'un thread d'exploitation
+ *
+ */
+typedef struct
+{
+    Evaluator* evaluator;           // Exploitation parallele
+    uint32_t index;                 // Rang du thread
+} Worker;
+
+/** Thread d'exploitation
+ *
+ */
+static void* run( void* arg );
+
+/** Creation de la structure de donnees commune aux deux types d'exploitation
+ *
+ */
+static Evaluator* create( uint32_t nbThreads, uint32_t inputSize, uint32_t outputSize );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Evaluator* EVALUATOR_create( const Network* network, uint32_t nbThreads )
+{
+    Evaluator* evaluator = create( nbThreads, network->input->nbNeurons, network->output->nbNeurons );
+    evaluator->network = network;
+
+    // Un espace de travail d'exploitation par thread
+    evaluator->workspaces = (Workspace**)malloc( evaluator->nbThreads * sizeof( Workspace* ) );
+    for( uint32_t i = 0; i < evaluator->nbThreads; ++i )
+    {
+        evaluator->workspaces[i] = WORKSPACE_create( network, evaluator->batchSize, 0 );
+    }
+
+    return( evaluator );
+}
+
+
+Evaluator* EVALUATOR_createQuantized( const QuantizedNetwork* network, uint32_t nbThreads )
+{
+    Evaluator* evaluator = create( nbThreads, network->inputSize, network->layers[network->nbLayers - 1].nbNeurons );
+    evaluator->quantized = network;
+
+    // Des buffers de travail par thread
+    evaluator->scratches = (QuantizedScratch**)malloc( evaluator->nbThreads * sizeof( QuantizedScratch* ) );
+    for( uint32_t i = 0; i < evaluator->nbThreads; ++i )
+    {
+        evaluator->scratches[i] = QUANTIZED_createScratch( network );
+    }
+
+    return( evaluator );
+}
+
+
+void EVALUATOR_run( Evaluator* evaluator, const Dataset* dataset, int16_t* predicted, double* probabilities )
+{
+    // Echantillons a classifier
+    evaluator->nbSamples = dataset->nbSamples;
+    evaluator->dataset = dataset;
+    evaluator->predicted = predicted;
+    evaluator->probabilities = probabilities;
+
+    // Avec un seul thread, la classification se fait dans le thread appelant
+    Worker* workers = (Worker*)calloc( evaluator->nbThreads, sizeof( Worker ) );
+    for( uint32_t i = 0; i < evaluator->nbThreads; ++i )
+    {
+        workers[i].evaluator = evaluator;
+        workers[i].index = i;
+    }
+    if( evaluator->nbThreads == 1 )
+    {
+        run( &workers[0] );
+    }
+    else
+    {
+        // Lancement des threads d'exploitation (les tranches des threads qui n'ont pas pu etre lances sont
+        // classifiees par le thread appelant), et attente de la fin de la classification
+        pthread_t* threads = (pthread_t*)malloc( evaluator->nbThreads * sizeof( pthread_t ) );
+        uint32_t nbStarted = 0;
+        while( nbStarted < evaluator->nbThreads &&
+               pthread_create( &threads[nbStarted], NULL, run, &workers[nbStarted] ) == 0 )
+        {
+            nbStarted++;
+        }
+        for( uint32_t i = nbStarted; i < evaluator->nbThreads; ++i ) run( &workers[i] );
+        for( uint32_t i = 0; i < nbStarted; ++i ) pthread_join( threads[i], NULL );
+        free( threads );
+    }
+
+    free( workers );
+}
+
+
+void EVALUATOR_destroy( Evaluator* evaluator )
+{
+    // Si valide
+    if( evaluator != NULL )
+    {
+        // Liberation des espaces de travail
+        for( uint32_t i = 0; i < evaluator->nbThreads; ++i )
+        {
+            if( evaluator->workspaces != NULL ) WORKSPACE_destroy( evaluator->workspaces[i] );
+            if( evaluator->scratches != NULL ) QUANTIZED_destroyScratch( evaluator->scratches[i] );
+            SAMPLE_destroyPool( evaluator->batches[i], evaluator->batchSize );
+        }
+
+        // Liberation memoire
+        free( evaluator->workspaces );
+        free( evaluator->scratches );
+        free( evaluator->batches );
+        free( evaluator );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void* run( void* arg )
+{
+    Worker* worker = (Worker*)arg;
+    Evaluator* evaluator = worker->evaluator;
+    Workspace* workspace = ( evaluator->workspaces != NULL ? evaluator->workspaces[worker->index] : NULL );
+    QuantizedScratch* scratch = ( evaluator->scratches != NULL ? evaluator->scratches[worker->index] : NULL );
+    Sample** batch = evaluator->batches[worker->index];
+    uint32_t indexes[BATCH_SIZE];
+
+    // Chaque thread traite une tranche contigue des echantillons, par lots
+    const uint32_t begin = (uint32_t)( (uint64_t)evaluator->nbSamples * worker->index / evaluator->nbThreads );
+    const uint32_t end = (uint32_t)( (uint64_t)evaluator->nbSamples * ( worker->index + 1 ) / evaluator->nbThreads );
+    for( uint32_t first = begin; first < end; first += evaluator->batchSize )
+    {
+        // Chargement des images dans les echantillons du lot, sans les sorties attendues
+        uint32_t nbLoaded = 0;
+        for( uint32_t i = first; i < end && i < first + evaluator->batchSize; ++i )
+        {
+            evaluator->predicted[i] = -1;
+            evaluator->probabilities[i] = 0.0;
+            if( DATASET_loadSample( evaluator->dataset, i, 0, batch[nbLoaded] ) != 0 ) continue;
+            indexes[nbLoaded++] = i;
+        }
+        if( nbLoaded == 0 ) continue;
+
+        // Reseau quantifie : classification des echantillons un par un (la perte n'est pas suivie)
+        if( evaluator->quantized != NULL )
+        {
+            uint32_t nbCorrect = 0;
+            for( uint32_t i = 0; i < nbLoaded; ++i )
+            {
+                const uint32_t index = indexes[i];
+                evaluator->predicted[index] = QUANTIZED_classify( evaluator->quantized, scratch, batch[i],
+                                                                  &evaluator->probabilities[index] );
+                nbCorrect += ( evaluator->predicted[index] == evaluator->dataset->labels[index] );
+            }
+            if( evaluator->report != NULL ) REPORT_add( evaluator->report, nbLoaded, nbCorrect, 0.0, 0 );
+            continue;
+        }
+
+        // Propagation du lot, et classification de chaque echantillon
+        NETWORK_infer( evaluator->network, workspace, batch, nbLoaded );
+        for( uint32_t i = 0; i < nbLoaded; ++i )
+        {
+            const uint32_t index = indexes[i];
+            evaluator->predicted[index] = NETWORK_classify( evaluator->network, workspace, i,
+                                                            &evaluator->probabilities[index] );
+        }
+
+        // Perte et precision du lot (les echantillons etant charges sans etiquette, le chiffre attendu est
+        // celui du jeu de donnees)
+        if( evaluator->report != NULL )
+        {
+            const Layer* output = evaluator->network->output;
+            const Real* outputs = workspace->outputs[output->index];
+            double loss = 0.0;
+            uint32_t nbCorrect = 0;
+            for( uint32_t i = 0; i < nbLoaded; ++i )
+            {
+                uint8_t correct = 0;
+                loss += REPORT_loss( outputs + (size_t)i * output->nbNeurons, output->nbNeurons,
+                                     evaluator->dataset->labels[indexes[i]], &correct );
+                nbCorrect += correct;
+            }
+            REPORT_add( evaluator->report, nbLoaded, nbCorrect, loss, nbLoaded );
+        }
+    }
+
+    return( NULL );
+}
+
+
+static Evaluator* create( uint32_t nbThreads, uint32_t inputSize, uint32_t outputSize )
+{
+    // Allocation de la struture de donnees
+    Evaluator* evaluator = (Evaluator*)malloc( sizeof( Evaluator ) );
+    memset( evaluator, 0, sizeof( Evaluator ) );
+    evaluator->batchSize = BATCH_SIZE;
+
+    // Nombre de threads (tous les coeurs disponibles si non specifie)
+    evaluator->nbThreads = nbThreads;
+    if( evaluator->nbThreads == 0 ) evaluator->nbThreads = (uint32_t)sysconf( _SC_NPROCESSORS_ONLN );
+
+    // Un lot d'echantillons par thread, reutilise d'un lot a l'autre
+    evaluator->batches = (Sample***)malloc( evaluator->nbThreads * sizeof( Sample** ) );
+    for( uint32_t i = 0; i < evaluator->nbThreads; ++i )
+    {
+        evaluator->batches[i] = SAMPLE_createPool( evaluator->batchSize, inputSize, outputSize );
+    }
+
+    return( evaluator );
+}
@@ -0,0 +1,458 @@
+#include "ia/ingest.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// Interface io_uring du noyau (appels systemes directs, sans bibliotheque) : operations d'ouverture et de
+// lecture de fichier disponibles a partir de Linux 5.6
+#if defined( __linux__ ) && defined( __has_include )
+#if __has_include( <linux/io_uring.h> )
+#include <linux/io_uring.h>
+#if defined( IORING_FEAT_RW_CUR_POS ) && defined( __NR_io_uring_setup ) && defined( __NR_io_uring_enter )
+#define INGEST_HAS_URING
+#endif
+#endif
+#endif
+
+// Nombre de fichiers en cours de lecture simultanement (io_uring)
+#define QUEUE_DEPTH 64
+
+// Nombre de threads de lecture (repli sans io_uring)
+#define NB_THREADS 16
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Lecture en cours : fichiers a lire, traitement, et bilan (partage par les threads de lecture)
+ *
+ */
+typedef struct
+{
+    char* const* files;             // Fichiers a lire
+    uint32_t nbFiles;               // Nombre de fichiers
+    size_t maxSize;                 // Nombre maximal d'octets lus par fichier
+    IngestCallback callback;        // Traitement du contenu de chaque fichier
+    void* context;                  // Contexte du traitement
+    atomic_uint next;               // Rang du prochain fichier a lire (threads)
+    atomic_uint nbFailed;           // Nombre de fichiers en echec
+    atomic_ullong nbBytes;          // Nombre d'octets lus
+} Job;
+
+/** Fin de la lecture d'un fichier : traitement du contenu (size octets du buffer), ou echec si size est negatif
+ *
+ */
+static void finish( Job* job, uint32_t index, uint8_t* buffer, ssize_t size );
+
+/** Lecture bloquante d'un fichier (au plus maxSize octets)
+ *
+ *  Retourne le nombre d'octets lus, ou -1 si le fichier n'a pas pu etre ouvert
+ */
+static ssize_t readFile( const char* file, uint8_t* buffer, size_t maxSize );
+
+/** Lecture sequentielle des fichiers, un a la fois
+ *
+ */
+static void readSequential( Job* job );
+
+/** Lecture des fichiers par un groupe de threads
+ *
+ */
+static void readThreads( Job* job );
+
+/** Thread de lecture : fichiers suivants de la liste, jusqu'a la fin de celle-ci
+ *
+ */
+static void* runThread( void* arg );
+
+/** Lecture des fichiers par paquets de demandes soumises a io_uring
+ *
+ *  Retourne 0 si io_uring a pu etre utilise (1 sinon, aucun fichier n'est alors lu)
+ */
+static int readUring( Job* job );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+uint32_t INGEST_readFiles( uint8_t backend, char* const* files, uint32_t nbFiles, size_t maxSize,
+                           IngestCallback callback, void* context, IngestStats* stats )
+{
+    Job job;
+    job.files = files;
+    job.nbFiles = nbFiles;
+    job.maxSize = maxSize;
+    job.callback = callback;
+    job.context = context;
+    atomic_init( &job.next, 0 );
+    atomic_init( &job.nbFailed, 0 );
+    atomic_init( &job.nbBytes, 0 );
+
+    // Lecture avec la methode demandee (repli sur les threads si io_uring n'est pas disponible)
+    struct timespec start, end;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    if( backend == INGEST_URING && readUring( &job ) != 0 ) backend = INGEST_THREADS;
+    if( backend == INGEST_THREADS ) readThreads( &job );
+    else if( backend != INGEST_URING ) readSequential( &job );
+    clock_gettime( CLOCK_MONOTONIC, &end );
+
+    // Bilan
+    const uint32_t nbFailed = atomic_load( &job.nbFailed );
+    if( stats != NULL )
+    {
+        stats->backend = ( backend <= INGEST_URING ? backend : INGEST_NONE );
+        stats->nbFiles = nbFiles;
+        stats->nbFailed = nbFailed;
+        stats->nbBytes = atomic_load( &job.nbBytes );
+        stats->duration = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+    }
+
+    return( nbFailed );
+}
+
+
+const char* INGEST_name( uint8_t backend )
+{
+    switch( backend )
+    {
+        case INGEST_THREADS: return( "threads" );
+        case INGEST_URING:   return( "io_uring" );
+        default:             return( "sequentiel" );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void finish( Job* job, uint32_t index, uint8_t* buffer, ssize_t size )
+{
+    if( size < 0 )
+    {
+        fprintf( stderr, "ERREUR - Impossible de lire le fichier : %s\n", job->files[index] );
+        atomic_fetch_add( &job->nbFailed, 1 );
+        return;
+    }
+
+    // Traitement du contenu (termine par un octet nul)
+    buffer[size] = '\0';
+    atomic_fetch_add_explicit( &job->nbBytes, (unsigned long long)size, memory_order_relaxed );
+    if( job->callback( job->context, index, buffer, (size_t)size ) != 0 ) atomic_fetch_add( &job->nbFailed, 1 );
+}
+
+
+static ssize_t readFile( const char* file, uint8_t* buffer, size_t maxSize )
+{
+    const int fd = open( file, O_RDONLY );
+    if( fd < 0 ) return( -1 );
+
+    ssize_t size = 0, nbRead = 0;
+    while( (size_t)size < maxSize && ( nbRead = pread( fd, buffer + size, maxSize - size, size ) ) > 0 )
+    {
+        size += nbRead;
+    }
+    close( fd );
+
+    return( nbRead < 0 ? -1 : size );
+}
+
+
+static void readSequential( Job* job )
+{
+    uint8_t* buffer = (uint8_t*)malloc( job->maxSize + 1 );
+    for( uint32_t i = 0; i < job->nbFiles; ++i )
+    {
+        finish( job, i, buffer, readFile( job->files[i], buffer, job->maxSize ) );
+    }
+    free( buffer );
+}
+
+
+static void readThreads( Job* job )
+{
+    // Les threads se partagent les fichiers de la liste au fur et a mesure (pas de repartition prealable)
+    const uint32_t nbThreads = ( job->nbFiles < NB_THREADS ? job->nbFiles : NB_THREADS );
+    pthread_t threads[NB_THREADS];
+    uint32_t nbStarted = 0;
+    while( nbStarted < nbThreads && pthread_create( &threads[nbStarted], NULL, runThread, job ) == 0 ) nbStarted++;
+
+    // Si aucun thread n'a pu etre lance, le thread appelant lit lui-meme les fichiers
+    if( nbStarted == 0 ) runThread( job );
+    for( uint32_t i = 0; i < nbStarted; ++i ) pthread_join( threads[i], NULL );
+}
+
+
+static void* runThread( void* arg )
+{
+    Job* job = (Job*)arg;
+    uint8_t* buffer = (uint8_t*)malloc( job->maxSize + 1 );
+    for( uint32_t i = atomic_fetch_add( &job->next, 1 ); i < job->nbFiles; i = atomic_fetch_add( &job->next, 1 ) )
+    {
+        finish( job, i, buffer, readFile( job->files[i], buffer, job->maxSize ) );
+    }
+    free( buffer );
+
+    return( NULL );
+}
+
+
+#ifdef INGEST_HAS_URING
+
+/** Anneaux de soumission et de completion partages avec le noyau
+ *
+ */
+typedef struct
+{
+    int fd;                         // Descripteur de l'instance io_uring
+    void* sqRing;                   // Projection de l'anneau de soumission
+    size_t sqRingSize;              // Taille de la projection de l'anneau de soumission
+    void* cqRing;                   // Projection de l'anneau de completion (eventuellement la meme)
+    size_t cqRingSize;              // Taille de la projection de l'anneau de completion
+    struct io_uring_sqe* sqes;      // Demandes soumises
+    size_t sqesSize;                // Taille de la projection des demandes
+    unsigned* sqTail;               // Fin de l'anneau de soumission (ecrite par l'application)
+    unsigned sqMask;                // Masque des rangs de l'anneau de soumission
+    unsigned* cqHead;               // Debut de l'anneau de completion (ecrit par l'application)
+    unsigned* cqTail;               // Fin de l'anneau de completion (ecrite par le noyau)
+    unsigned cqMask;                // Masque des rangs de l'anneau de completion
+    struct io_uring_cqe* cqes;      // Resultats des demandes
+} Ring;
+
+/** Lecture d'un fichier en cours (io_uring) : ouverture, puis lectures jusqu'a la fin du fichier
+ *
+ */
+typedef struct
+{
+    uint32_t index;                 // Rang du fichier
+    int fd;                         // Descripteur du fichier (negatif tant qu'il n'est pas ouvert)
+    size_t size;                    // Nombre d'octets deja lus
+    uint8_t* buffer;                // Contenu du fichier
+} Slot;
+
+
+/** Creation d'une instance io_uring et projection de ses anneaux
+ *
+ *  Retourne 0 si io_uring est disponible et supporte les operations de fichier
+ */
+static int createRing( Ring* ring, unsigned entries )
+{
+    struct io_uring_params params;
+    memset( &params, 0, sizeof( params ) );
+    memset( ring, 0, sizeof( Ring ) );
+    ring->fd = (int)syscall( __NR_io_uring_setup, entries, &params );
+    if( ring->fd < 0 ) return( 1 );
+    if( !( params.features & IORING_FEAT_RW_CUR_POS ) )
+    {
+        close( ring->fd );
+        return( 1 );
+    }
+
+    // Projection des anneaux (une seule projection pour les deux si le noyau le permet)
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+    if( params.features & IORING_FEAT_SINGLE_MMAP )
+    {
+        if( ring->cqRingSize > ring->sqRingSize ) ring->sqRingSize = ring->cqRingSize;
+        ring->cqRingSize = 0;
+    }
+    ring->sqRing = mmap( NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING );
+    ring->cqRing = ring->sqRing;
+    if( ring->sqRing != MAP_FAILED && ring->cqRingSize > 0 )
+    {
+        ring->cqRing = mmap( NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                             IORING_OFF_CQ_RING );
+    }
+    ring->sqesSize = params.sq_entries * sizeof( struct io_uring_sqe );
+    ring->sqes = (struct io_uring_sqe*)mmap( NULL, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                             MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES );
+    if( ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || ring->sqes == MAP_FAILED )
+    {
+        if( ring->sqes != MAP_FAILED ) munmap( ring->sqes, ring->sqesSize );
+        if( ring->cqRing != MAP_FAILED && ring->cqRing != ring->sqRing ) munmap( ring->cqRing, ring->cqRingSize );
+        if( ring->sqRing != MAP_FAILED ) munmap( ring->sqRing, ring->sqRingSize );
+        close( ring->fd );
+        return( 1 );
+    }
+
+    // Pointeurs dans les anneaux. Le rang i de l'anneau de soumission designe toujours la demande i
+    uint8_t* sq = (uint8_t*)ring->sqRing;
+    uint8_t* cq = (uint8_t*)ring->cqRing;
+    ring->sqTail = (unsigned*)( sq + params.sq_off.tail );
+    ring->sqMask = *(unsigned*)( sq + params.sq_off.ring_mask );
+    unsigned* array = (unsigned*)( sq + params.sq_off.array );
+    for( unsigned i = 0; i < params.sq_entries; ++i ) array[i] = i;
+    ring->cqHead = (unsigned*)( cq + params.cq_off.head );
+    ring->cqTail = (unsigned*)( cq + params.cq_off.tail );
+    ring->cqMask = *(unsigned*)( cq + params.cq_off.ring_mask );
+    ring->cqes = (struct io_uring_cqe*)( cq + params.cq_off.cqes );
+
+    return( 0 );
+}
+
+
+/** Destruction d'une instance io_uring (les demandes en cours sont annulees)
+ *
+ */
+static void destroyRing( Ring* ring )
+{
+    munmap( ring->sqes, ring->sqesSize );
+    if( ring->cqRing != ring->sqRing ) munmap( ring->cqRing, ring->cqRingSize );
+    munmap( ring->sqRing, ring->sqRingSize );
+    close( ring->fd );
+}
+
+
+/** Ajout d'une demande a l'anneau de soumission (publiee au noyau lors de la prochaine soumission)
+ *
+ */
+static struct io_uring_sqe* nextRequest( Ring* ring, unsigned* tail )
+{
+    struct io_uring_sqe* sqe = &ring->sqes[*tail & ring->sqMask];
+    memset( sqe, 0, sizeof( struct io_uring_sqe ) );
+    ( *tail )++;
+
+    return( sqe );
+}
+
+
+/** Demande d'ouverture du fichier de la lecture specifiee
+ *
+ */
+static void requestOpen( Ring* ring, unsigned* tail, const Job* job, const Slot* slot, uint32_t slotIndex )
+{
+    struct io_uring_sqe* sqe = nextRequest( ring, tail );
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t)(uintptr_t)job->files[slot->index];
+    sqe->open_flags = O_RDONLY;
+    sqe->user_data = slotIndex;
+}
+
+
+/** Demande de lecture de la suite du fichier de la lecture specifiee
+ *
+ */
+static void requestRead( Ring* ring, unsigned* tail, const Job* job, const Slot* slot, uint32_t slotIndex )
+{
+    struct io_uring_sqe* sqe = nextRequest( ring, tail );
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = slot->fd;
+    sqe->addr = (uint64_t)(uintptr_t)( slot->buffer + slot->size );
+    sqe->len = (uint32_t)( job->maxSize - slot->size );
+    sqe->off = slot->size;
+    sqe->user_data = slotIndex;
+}
+
+
+static int readUring( Job* job )
+{
+    Ring ring;
+    if( createRing( &ring, QUEUE_DEPTH ) != 0 ) return( 1 );
+
+    // Une lecture en cours par emplacement, chacun avec son buffer : les premiers fichiers sont ouverts
+    Slot slots[QUEUE_DEPTH];
+    uint8_t* buffers = (uint8_t*)malloc( QUEUE_DEPTH * ( job->maxSize + 1 ) );
+    unsigned tail = *ring.sqTail;
+    uint32_t nextFile = 0, nbActive = 0, nbDone = 0;
+    for( uint32_t s = 0; s < QUEUE_DEPTH && nextFile < job->nbFiles; ++s, ++nbActive )
+    {
+        slots[s].index = nextFile++;
+        slots[s].fd = -1;
+        slots[s].size = 0;
+        slots[s].buffer = buffers + s * ( job->maxSize + 1 );
+        requestOpen( &ring, &tail, job, &slots[s], s );
+    }
+
+    while( nbActive > 0 )
+    {
+        // Soumission des nouvelles demandes, et attente d'au moins un resultat
+        const unsigned nbSubmitted = tail - *ring.sqTail;
+        __atomic_store_n( ring.sqTail, tail, __ATOMIC_RELEASE );
+        if( syscall( __NR_io_uring_enter, ring.fd, nbSubmitted, 1, IORING_ENTER_GETEVENTS, NULL, 0 ) < 0 )
+        {
+            if( errno == EINTR ) continue;
+            fprintf( stderr, "ERREUR - Echec de lecture io_uring (%s)\n", strerror( errno ) );
+            break;
+        }
+
+        // Traitement des resultats : chaque fichier ouvert est lu, chaque fichier lu est traite, et son
+        // emplacement est reutilise pour le fichier suivant
+        unsigned head = *ring.cqHead;
+        const unsigned cqTail = __atomic_load_n( ring.cqTail, __ATOMIC_ACQUIRE );
+        for( ; head != cqTail; ++head )
+        {
+            const struct io_uring_cqe* cqe = &ring.cqes[head & ring.cqMask];
+            const uint32_t s = (uint32_t)cqe->user_data;
+            Slot* slot = &slots[s];
+            if( slot->fd < 0 && cqe->res >= 0 )
+            {
+                // Fichier ouvert : lecture
+                slot->fd = cqe->res;
+                requestRead( &ring, &tail, job, slot, s );
+                continue;
+            }
+            if( slot->fd >= 0 && cqe->res > 0 )
+            {
+                // Lecture partielle : la suite du fichier est demandee, sauf si le buffer est plein ou si la
+                // lecture est courte (fin d'un fichier ordinaire)
+                const size_t requested = job->maxSize - slot->size;
+                slot->size += (size_t)cqe->res;
+                if( slot->size < job->maxSize && (size_t)cqe->res == requested )
+                {
+                    requestRead( &ring, &tail, job, slot, s );
+                    continue;
+                }
+            }
+
+            // Fichier termine (lu entierement, ou en echec)
+            const uint8_t failed = ( cqe->res < 0 );
+            if( slot->fd >= 0 ) close( slot->fd );
+            slot->fd = -1;
+            finish( job, slot->index, slot->buffer, failed ? -1 : (ssize_t)slot->size );
+            nbDone++;
+
+            // Fichier suivant dans l'emplacement libere
+            if( nextFile < job->nbFiles )
+            {
+                slot->index = nextFile++;
+                slot->fd = -1;
+                slot->size = 0;
+                requestOpen( &ring, &tail, job, slot, s );
+            }
+            else
+            {
+                nbActive--;
+            }
+        }
+        __atomic_store_n( ring.cqHead, head, __ATOMIC_RELEASE );
+    }
+
+    // Fichiers non lus (echec d'io_uring en cours de lecture)
+    if( nbDone < job->nbFiles ) atomic_fetch_add( &job->nbFailed, job->nbFiles - nbDone );
+    destroyRing( &ring );
+    for( uint32_t s = 0; s < QUEUE_DEPTH && s < job->nbFiles; ++s )
+    {
+        if( slots[s].fd >= 0 ) close( slots[s].fd );
+    }
+    free( buffers );
+
+    return( 0 );
+}
+
+#else
+
+static int readUring( Job* job )
+{
+    (void)job;
+
+    return( 1 );
+}
+
+#endif
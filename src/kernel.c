@@ -0,0 +1,1990 @@
+#include "ia/kernel.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined( __x86_64__ )
+#include <immintrin.h>
+#define KERNEL_X86
+#endif
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Jeu de noyaux de calcul
+ *
+ */
+typedef struct
+{
+    const char* name;
+    Real (*dot)( const Real* x, const Real* y, uint32_t n );
+    void (*axpy)( Real* y, Real a, const Real* x, uint32_t n );
+    void (*axpyUpdate)( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n );
+    void (*momentum)( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n );
+    void (*adam)( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                  const Real* x, uint32_t n );
+    void (*exp)( Real* values, Real scale, Real shift, uint32_t n );
+    void (*sigmoid)( Real* values, Real lambda, uint32_t n );
+    int32_t (*dotInt8)( const uint8_t* x, const int8_t* y, uint32_t n );
+    Real (*dotSparse)( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n );
+    void (*axpySparse)( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n );
+    uint64_t (*peak)( uint32_t nbIterations, Real* result );
+} KernelSet;
+
+/** Noyaux scalaires (reference, et processeurs non x86)
+ *
+ */
+static Real dotScalar( const Real* x, const Real* y, uint32_t n );
+static void axpyScalar( Real* y, Real a, const Real* x, uint32_t n );
+static void axpyUpdateScalar( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n );
+static void momentumScalar( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n );
+static void adamScalar( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                      const Real* x, uint32_t n );
+static void expScalar( Real* values, Real scale, Real shift, uint32_t n );
+static void sigmoidScalar( Real* values, Real lambda, uint32_t n );
+static int32_t dotInt8Scalar( const uint8_t* x, const int8_t* y, uint32_t n );
+static Real dotSparseScalar( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n );
+static void axpySparseScalar( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n );
+static uint64_t peakScalar( uint32_t nbIterations, Real* result );
+
+/** Exponentielle approchee d'un scalaire (noyaux scalaires, et elements restants des noyaux vectorises)
+ *
+ */
+static double expApprox( double x );
+
+#ifdef KERNEL_X86
+/** Noyaux SSE2 (vecteurs de 128 bits, soit 2 doubles ou 4 floats, supportes par tous les processeurs x86-64)
+ *
+ */
+static Real dotSSE2( const Real* x, const Real* y, uint32_t n );
+static void axpySSE2( Real* y, Real a, const Real* x, uint32_t n );
+static void axpyUpdateSSE2( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n );
+static void momentumSSE2( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n );
+static void adamSSE2( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                    const Real* x, uint32_t n );
+static void expSSE2( Real* values, Real scale, Real shift, uint32_t n );
+static void sigmoidSSE2( Real* values, Real lambda, uint32_t n );
+static int32_t dotInt8SSE2( const uint8_t* x, const int8_t* y, uint32_t n );
+static uint64_t peakSSE2( uint32_t nbIterations, Real* result );
+
+/** Noyaux AVX2/FMA (vecteurs de 256 bits, soit 4 doubles ou 8 floats)
+ *
+ */
+static Real dotAVX2( const Real* x, const Real* y, uint32_t n );
+static void axpyAVX2( Real* y, Real a, const Real* x, uint32_t n );
+static void axpyUpdateAVX2( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n );
+static void momentumAVX2( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n );
+static void adamAVX2( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                    const Real* x, uint32_t n );
+static void expAVX2( Real* values, Real scale, Real shift, uint32_t n );
+static void sigmoidAVX2( Real* values, Real lambda, uint32_t n );
+static int32_t dotInt8AVX2( const uint8_t* x, const int8_t* y, uint32_t n );
+static Real dotSparseAVX2( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n );
+static uint64_t peakAVX2( uint32_t nbIterations, Real* result );
+
+/** Noyaux AVX-512 (vecteurs de 512 bits, soit 8 doubles ou 16 floats)
+ *
+ */
+static Real dotAVX512( const Real* x, const Real* y, uint32_t n );
+static void axpyAVX512( Real* y, Real a, const Real* x, uint32_t n );
+static void axpyUpdateAVX512( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n );
+static void momentumAVX512( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n );
+static void adamAVX512( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                    const Real* x, uint32_t n );
+static void expAVX512( Real* values, Real scale, Real shift, uint32_t n );
+static void sigmoidAVX512( Real* values, Real lambda, uint32_t n );
+static Real dotSparseAVX512( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n );
+static void axpySparseAVX512( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n );
+static uint64_t peakAVX512( uint32_t nbIterations, Real* result );
+
+// NOTE: le jeu AVX-512 n'exige que AVX-512F, qui n'a pas d'instructions entieres 8 bits : le produit scalaire
+//       entier est donc celui du jeu AVX2 (supporte par tous les processeurs AVX-512)
+// NOTE: SSE2 n'a pas d'instruction de chargement indexe (gather), et seul AVX-512 a celle d'ecriture indexee
+//       (scatter) : les noyaux creux des jeux SSE2 et AVX2 qui en auraient besoin sont les noyaux scalaires
+#endif
+
+
+//--- Donnees locales ------------------------------------------------------------------------------------------
+
+// Exponentielle approchee : x = k.ln2 + r (|r| <= ln2/2), puis exp( x ) = 2^k.P( r ), P etant le developpement
+// de Taylor de exp a l'ordre 7. L'argument est borne de sorte que 2^k soit un flottant normalise
+#ifdef IA_FLOAT32
+#define EXP_MIN -87.0                   // Borne inferieure de l'argument
+#define EXP_MAX 88.0                    // Borne superieure de l'argument
+#define LN2_HI 0.693359375              // ln2 (poids forts, k.LN2_HI est exact)
+#define LN2_LO -2.12194440e-4           // ln2 (poids faibles)
+#else
+#define EXP_MIN -708.0                  // Borne inferieure de l'argument
+#define EXP_MAX 709.0                   // Borne superieure de l'argument
+#define LN2_HI 6.93147180369123816490e-01   // ln2 (poids forts, k.LN2_HI est exact)
+#define LN2_LO 1.90821492927058770002e-10   // ln2 (poids faibles)
+#endif
+#define LOG2E 1.44269504088896340736    // 1 / ln2
+#define EXP_C2 ( 1.0 / 2.0 )            // Coefficients du polynome (1 / i!)
+#define EXP_C3 ( 1.0 / 6.0 )
+#define EXP_C4 ( 1.0 / 24.0 )
+#define EXP_C5 ( 1.0 / 120.0 )
+#define EXP_C6 ( 1.0 / 720.0 )
+#define EXP_C7 ( 1.0 / 5040.0 )
+
+// Mesure de la crete de calcul : nombre de chaines independantes de multiplications-additions (au moins la
+// latence d'une FMA multipliee par le nombre d'unites qui les executent)
+#define PEAK_CHAINS 12
+
+// Jeux de noyaux disponibles, du moins performant au plus performant
+static const KernelSet KERNELS[] =
+{
+    { "scalar", dotScalar, axpyScalar, axpyUpdateScalar, momentumScalar, adamScalar, expScalar, sigmoidScalar,
+      dotInt8Scalar, dotSparseScalar, axpySparseScalar, peakScalar },
+#ifdef KERNEL_X86
+    { "sse2", dotSSE2, axpySSE2, axpyUpdateSSE2, momentumSSE2, adamSSE2, expSSE2, sigmoidSSE2, dotInt8SSE2,
+      dotSparseScalar, axpySparseScalar, peakSSE2 },
+    { "avx2", dotAVX2, axpyAVX2, axpyUpdateAVX2, momentumAVX2, adamAVX2, expAVX2, sigmoidAVX2, dotInt8AVX2,
+      dotSparseAVX2, axpySparseScalar, peakAVX2 },
+    { "avx512", dotAVX512, axpyAVX512, axpyUpdateAVX512, momentumAVX512, adamAVX512, expAVX512, sigmoidAVX512,
+      dotInt8AVX2, dotSparseAVX512, axpySparseAVX512, peakAVX512 },
+#endif
+};
+
+// Jeu de noyaux courant (jeu de base tant que KERNEL_init() n'a pas ete appelee)
+#ifdef KERNEL_X86
+static const KernelSet* current = &KERNELS[1];
+#else
+static const KernelSet* current = &KERNELS[0];
+#endif
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+const char* KERNEL_init()
+{
+    // Jeu de noyaux le plus performant supporte par le processeur
+    const KernelSet* best = &KERNELS[0];
+#ifdef KERNEL_X86
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx512f" ) ) best = &KERNELS[3];
+    else if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) ) best = &KERNELS[2];
+    else best = &KERNELS[1];
+#endif
+    current = best;
+
+    // Jeu de noyaux force par l'environnement (s'il est supporte)
+    const char* forced = getenv( "IA_KERNEL" );
+    if( forced != NULL )
+    {
+        for( const KernelSet* kernel = KERNELS; kernel <= best; ++kernel )
+        {
+            if( strcmp( kernel->name, forced ) == 0 ) current = kernel;
+        }
+        if( strcmp( current->name, forced ) != 0 )
+        {
+            fprintf( stderr, "ATTENTION - Jeu de noyaux %s non supporte, utilisation de %s\n", forced, current->name );
+        }
+    }
+
+    return( current->name );
+}
+
+
+const char* KERNEL_name()
+{
+    return( current->name );
+}
+
+
+Real KERNEL_dot( const Real* x, const Real* y, uint32_t n )
+{
+    return( current->dot( x, y, n ) );
+}
+
+
+void KERNEL_axpy( Real* y, Real a, const Real* x, uint32_t n )
+{
+    current->axpy( y, a, x, n );
+}
+
+
+void KERNEL_axpyUpdate( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    current->axpyUpdate( y, a, w, b, x, n );
+}
+
+
+void KERNEL_momentum( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    current->momentum( w, v, mu, s, c, d, x, n );
+}
+
+
+void KERNEL_adam( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                  const Real* x, uint32_t n )
+{
+    current->adam( w, m, v, beta1, beta2, s, step, epsilon, x, n );
+}
+
+
+void KERNEL_exp( Real* values, Real scale, Real shift, uint32_t n )
+{
+    current->exp( values, scale, shift, n );
+}
+
+
+void KERNEL_sigmoid( Real* values, Real lambda, uint32_t n )
+{
+    current->sigmoid( values, lambda, n );
+}
+
+
+int32_t KERNEL_dotInt8( const uint8_t* x, const int8_t* y, uint32_t n )
+{
+    return( current->dotInt8( x, y, n ) );
+}
+
+
+Real KERNEL_dotSparse( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n )
+{
+    return( current->dotSparse( values, indexes, y, n ) );
+}
+
+
+void KERNEL_axpySparse( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n )
+{
+    current->axpySparse( y, a, values, indexes, n );
+}
+
+
+uint64_t KERNEL_peak( uint32_t nbIterations, Real* result )
+{
+    return( current->peak( nbIterations, result ) );
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static Real dotScalar( const Real* x, const Real* y, uint32_t n )
+{
+    Real sum = 0;
+    for( uint32_t i = 0; i < n; ++i ) sum += x[i] * y[i];
+
+    return( sum );
+}
+
+
+static void axpyScalar( Real* y, Real a, const Real* x, uint32_t n )
+{
+    for( uint32_t i = 0; i < n; ++i ) y[i] += a * x[i];
+}
+
+
+static void axpyUpdateScalar( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    for( uint32_t i = 0; i < n; ++i )
+    {
+        y[i] += a * w[i];
+        w[i] += b * x[i];
+    }
+}
+
+
+static void momentumScalar( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    for( uint32_t i = 0; i < n; ++i )
+    {
+        v[i] = mu * v[i] + s * x[i];
+        w[i] += c * x[i] + d * v[i];
+    }
+}
+
+
+static void adamScalar( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                        const Real* x, uint32_t n )
+{
+    // Gradient g = s.x : les moyennes sont mises a jour avec ( 1 - beta1 ).g et ( 1 - beta2 ).g^2
+    const Real s1 = ( 1 - beta1 ) * s;
+    const Real s2 = ( 1 - beta2 ) * s * s;
+    for( uint32_t i = 0; i < n; ++i )
+    {
+        m[i] = beta1 * m[i] + s1 * x[i];
+        v[i] = beta2 * v[i] + s2 * x[i] * x[i];
+        w[i] -= step * m[i] / ( (Real)sqrt( v[i] ) + epsilon );
+    }
+}
+
+
+static void expScalar( Real* values, Real scale, Real shift, uint32_t n )
+{
+    for( uint32_t i = 0; i < n; ++i ) values[i] = expApprox( scale * values[i] + shift );
+}
+
+
+static void sigmoidScalar( Real* values, Real lambda, uint32_t n )
+{
+    for( uint32_t i = 0; i < n; ++i ) values[i] = 1.0 / ( 1.0 + expApprox( -lambda * values[i] ) );
+}
+
+
+static int32_t dotInt8Scalar( const uint8_t* x, const int8_t* y, uint32_t n )
+{
+    int32_t sum = 0;
+    for( uint32_t i = 0; i < n; ++i ) sum += (int32_t)x[i] * y[i];
+
+    return( sum );
+}
+
+
+static Real dotSparseScalar( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n )
+{
+    Real sum = 0;
+    for( uint32_t j = 0; j < n; ++j ) sum += values[j] * y[indexes[j]];
+
+    return( sum );
+}
+
+
+static void axpySparseScalar( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n )
+{
+    for( uint32_t j = 0; j < n; ++j ) y[indexes[j]] += a * values[j];
+}
+
+
+static uint64_t peakScalar( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b (les valeurs convergent vers 1, sans debordement ni denormalise)
+    const Real a = (Real)0.75;
+    const Real b = (Real)0.25;
+    Real x0 = 0;
+    Real x1 = 0;
+    Real x2 = 0;
+    Real x3 = 0;
+    Real x4 = 0;
+    Real x5 = 0;
+    Real x6 = 0;
+    Real x7 = 0;
+    Real x8 = 0;
+    Real x9 = 0;
+    Real x10 = 0;
+    Real x11 = 0;
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = x0 * a + b;
+        x1 = x1 * a + b;
+        x2 = x2 * a + b;
+        x3 = x3 * a + b;
+        x4 = x4 * a + b;
+        x5 = x5 * a + b;
+        x6 = x6 * a + b;
+        x7 = x7 * a + b;
+        x8 = x8 * a + b;
+        x9 = x9 * a + b;
+        x10 = x10 * a + b;
+        x11 = x11 * a + b;
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = x0 + x1;
+    x2 = x2 + x3;
+    x4 = x4 + x5;
+    x6 = x6 + x7;
+    x8 = x8 + x9;
+    x10 = x10 + x11;
+    x0 = x0 + x2;
+    x4 = x4 + x6;
+    x8 = x8 + x10;
+    x0 = x0 + x4;
+    x0 = x0 + x8;
+    *result = x0;
+
+    return( 2ull * PEAK_CHAINS * nbIterations );
+}
+
+
+static double expApprox( double x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r
+    x = ( x < EXP_MIN ? EXP_MIN : ( x > EXP_MAX ? EXP_MAX : x ) );
+    const double k = nearbyint( x * LOG2E );
+    const double r = ( x - k * LN2_HI ) - k * LN2_LO;
+
+    // Polynome (schema de Horner), puis multiplication par 2^k
+    double p = EXP_C7;
+    p = p * r + EXP_C6;
+    p = p * r + EXP_C5;
+    p = p * r + EXP_C4;
+    p = p * r + EXP_C3;
+    p = p * r + EXP_C2;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    return( ldexp( p, (int)k ) );
+}
+
+#if defined( KERNEL_X86 ) && !defined( IA_FLOAT32 )
+
+// Noyaux double precision
+
+static Real dotSSE2( const Real* x, const Real* y, uint32_t n )
+{
+    // Deux accumulateurs independants pour masquer la latence des additions
+    __m128d sum0 = _mm_setzero_pd();
+    __m128d sum1 = _mm_setzero_pd();
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        sum0 = _mm_add_pd( sum0, _mm_mul_pd( _mm_loadu_pd( x + i ), _mm_loadu_pd( y + i ) ) );
+        sum1 = _mm_add_pd( sum1, _mm_mul_pd( _mm_loadu_pd( x + i + 2 ), _mm_loadu_pd( y + i + 2 ) ) );
+    }
+    sum0 = _mm_add_pd( sum0, sum1 );
+
+    // Reduction, puis elements restants
+    double sum = _mm_cvtsd_f64( _mm_add_sd( sum0, _mm_unpackhi_pd( sum0, sum0 ) ) );
+    for( ; i < n; ++i ) sum += x[i] * y[i];
+
+    return( sum );
+}
+
+
+static void axpySSE2( Real* y, Real a, const Real* x, uint32_t n )
+{
+    const __m128d va = _mm_set1_pd( a );
+    uint32_t i = 0;
+    for( ; i + 2 <= n; i += 2 )
+    {
+        _mm_storeu_pd( y + i, _mm_add_pd( _mm_loadu_pd( y + i ), _mm_mul_pd( va, _mm_loadu_pd( x + i ) ) ) );
+    }
+    for( ; i < n; ++i ) y[i] += a * x[i];
+}
+
+
+static void axpyUpdateSSE2( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    // Les poids sont lus une seule fois : contribution a y avant leur mise a jour, puis mise a jour
+    const __m128d va = _mm_set1_pd( a );
+    const __m128d vb = _mm_set1_pd( b );
+    uint32_t i = 0;
+    for( ; i + 2 <= n; i += 2 )
+    {
+        const __m128d vw = _mm_loadu_pd( w + i );
+        _mm_storeu_pd( y + i, _mm_add_pd( _mm_loadu_pd( y + i ), _mm_mul_pd( va, vw ) ) );
+        _mm_storeu_pd( w + i, _mm_add_pd( vw, _mm_mul_pd( vb, _mm_loadu_pd( x + i ) ) ) );
+    }
+    for( ; i < n; ++i )
+    {
+        y[i] += a * w[i];
+        w[i] += b * x[i];
+    }
+}
+
+
+static void momentumSSE2( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    // Chaque poids et sa vitesse ne sont lus et ecrits qu'une seule fois
+    const __m128d vmu = _mm_set1_pd( mu );
+    const __m128d vs = _mm_set1_pd( s );
+    const __m128d vc = _mm_set1_pd( c );
+    const __m128d vd = _mm_set1_pd( d );
+    uint32_t i = 0;
+    for( ; i + 2 <= n; i += 2 )
+    {
+        const __m128d vx = _mm_loadu_pd( x + i );
+        const __m128d vv = _mm_add_pd( _mm_mul_pd( vmu, _mm_loadu_pd( v + i ) ), _mm_mul_pd( vs, vx ) );
+        _mm_storeu_pd( v + i, vv );
+        _mm_storeu_pd( w + i, _mm_add_pd( _mm_add_pd( _mm_loadu_pd( w + i ), _mm_mul_pd( vc, vx ) ),
+                                          _mm_mul_pd( vd, vv ) ) );
+    }
+    for( ; i < n; ++i )
+    {
+        v[i] = mu * v[i] + s * x[i];
+        w[i] += c * x[i] + d * v[i];
+    }
+}
+
+
+static void adamSSE2( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                      const Real* x, uint32_t n )
+{
+    // Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une seule fois
+    const Real s1 = ( 1 - beta1 ) * s;
+    const Real s2 = ( 1 - beta2 ) * s * s;
+    const __m128d vb1 = _mm_set1_pd( beta1 );
+    const __m128d vb2 = _mm_set1_pd( beta2 );
+    const __m128d vs1 = _mm_set1_pd( s1 );
+    const __m128d vs2 = _mm_set1_pd( s2 );
+    const __m128d vstep = _mm_set1_pd( step );
+    const __m128d veps = _mm_set1_pd( epsilon );
+    uint32_t i = 0;
+    for( ; i + 2 <= n; i += 2 )
+    {
+        const __m128d vx = _mm_loadu_pd( x + i );
+        const __m128d vm = _mm_add_pd( _mm_mul_pd( vb1, _mm_loadu_pd( m + i ) ), _mm_mul_pd( vs1, vx ) );
+        const __m128d vv = _mm_add_pd( _mm_mul_pd( vb2, _mm_loadu_pd( v + i ) ),
+                                       _mm_mul_pd( vs2, _mm_mul_pd( vx, vx ) ) );
+        _mm_storeu_pd( m + i, vm );
+        _mm_storeu_pd( v + i, vv );
+        const __m128d delta = _mm_div_pd( _mm_mul_pd( vstep, vm ), _mm_add_pd( _mm_sqrt_pd( vv ), veps ) );
+        _mm_storeu_pd( w + i, _mm_sub_pd( _mm_loadu_pd( w + i ), delta ) );
+    }
+    for( ; i < n; ++i )
+    {
+        m[i] = beta1 * m[i] + s1 * x[i];
+        v[i] = beta2 * v[i] + s2 * x[i] * x[i];
+        w[i] -= step * m[i] / ( (Real)sqrt( v[i] ) + epsilon );
+    }
+}
+
+
+static inline __m128d expVectorSSE2( __m128d x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r, k etant arrondi a l'entier le plus proche
+    x = _mm_min_pd( _mm_max_pd( x, _mm_set1_pd( EXP_MIN ) ), _mm_set1_pd( EXP_MAX ) );
+    const __m128i k = _mm_cvtpd_epi32( _mm_mul_pd( x, _mm_set1_pd( LOG2E ) ) );
+    const __m128d kd = _mm_cvtepi32_pd( k );
+    const __m128d r = _mm_sub_pd( _mm_sub_pd( x, _mm_mul_pd( kd, _mm_set1_pd( LN2_HI ) ) ),
+                                  _mm_mul_pd( kd, _mm_set1_pd( LN2_LO ) ) );
+
+    // Polynome (schema de Horner)
+    __m128d p = _mm_set1_pd( EXP_C7 );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( EXP_C6 ) );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( EXP_C5 ) );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( EXP_C4 ) );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( EXP_C3 ) );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( EXP_C2 ) );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( 1.0 ) );
+    p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( 1.0 ) );
+
+    // 2^k construit directement dans l'exposant (k + 1023, decale de 52 bits)
+    const __m128i exponent = _mm_unpacklo_epi32( _mm_add_epi32( k, _mm_set1_epi32( 1023 ) ), _mm_setzero_si128() );
+    return( _mm_mul_pd( p, _mm_castsi128_pd( _mm_slli_epi64( exponent, 52 ) ) ) );
+}
+
+
+static void expSSE2( Real* values, Real scale, Real shift, uint32_t n )
+{
+    const __m128d va = _mm_set1_pd( scale );
+    const __m128d vb = _mm_set1_pd( shift );
+    uint32_t i = 0;
+    for( ; i + 2 <= n; i += 2 )
+    {
+        _mm_storeu_pd( values + i, expVectorSSE2( _mm_add_pd( _mm_mul_pd( va, _mm_loadu_pd( values + i ) ), vb ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = expApprox( scale * values[i] + shift );
+}
+
+
+static void sigmoidSSE2( Real* values, Real lambda, uint32_t n )
+{
+    const __m128d va = _mm_set1_pd( -lambda );
+    const __m128d one = _mm_set1_pd( 1.0 );
+    uint32_t i = 0;
+    for( ; i + 2 <= n; i += 2 )
+    {
+        const __m128d e = expVectorSSE2( _mm_mul_pd( va, _mm_loadu_pd( values + i ) ) );
+        _mm_storeu_pd( values + i, _mm_div_pd( one, _mm_add_pd( one, e ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = 1.0 / ( 1.0 + expApprox( -lambda * values[i] ) );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static Real dotAVX2( const Real* x, const Real* y, uint32_t n )
+{
+    // Quatre accumulateurs independants pour masquer la latence des FMA
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    __m256d sum2 = _mm256_setzero_pd();
+    __m256d sum3 = _mm256_setzero_pd();
+    uint32_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        sum0 = _mm256_fmadd_pd( _mm256_loadu_pd( x + i ), _mm256_loadu_pd( y + i ), sum0 );
+        sum1 = _mm256_fmadd_pd( _mm256_loadu_pd( x + i + 4 ), _mm256_loadu_pd( y + i + 4 ), sum1 );
+        sum2 = _mm256_fmadd_pd( _mm256_loadu_pd( x + i + 8 ), _mm256_loadu_pd( y + i + 8 ), sum2 );
+        sum3 = _mm256_fmadd_pd( _mm256_loadu_pd( x + i + 12 ), _mm256_loadu_pd( y + i + 12 ), sum3 );
+    }
+    for( ; i + 4 <= n; i += 4 )
+    {
+        sum0 = _mm256_fmadd_pd( _mm256_loadu_pd( x + i ), _mm256_loadu_pd( y + i ), sum0 );
+    }
+    sum0 = _mm256_add_pd( _mm256_add_pd( sum0, sum1 ), _mm256_add_pd( sum2, sum3 ) );
+
+    // Reduction, puis elements restants
+    __m128d half = _mm_add_pd( _mm256_castpd256_pd128( sum0 ), _mm256_extractf128_pd( sum0, 1 ) );
+    double sum = _mm_cvtsd_f64( _mm_add_sd( half, _mm_unpackhi_pd( half, half ) ) );
+    for( ; i < n; ++i ) sum += x[i] * y[i];
+
+    return( sum );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static Real dotSparseAVX2( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n )
+{
+    // Elements de y charges d'apres leurs rangs (gather), deux accumulateurs independants
+    __m256d sum0 = _mm256_setzero_pd();
+    __m256d sum1 = _mm256_setzero_pd();
+    uint32_t j = 0;
+    for( ; j + 8 <= n; j += 8 )
+    {
+        const __m128i index0 = _mm_loadu_si128( (const __m128i*)( indexes + j ) );
+        const __m128i index1 = _mm_loadu_si128( (const __m128i*)( indexes + j + 4 ) );
+        sum0 = _mm256_fmadd_pd( _mm256_loadu_pd( values + j ), _mm256_i32gather_pd( y, index0, 8 ), sum0 );
+        sum1 = _mm256_fmadd_pd( _mm256_loadu_pd( values + j + 4 ), _mm256_i32gather_pd( y, index1, 8 ), sum1 );
+    }
+    for( ; j + 4 <= n; j += 4 )
+    {
+        const __m128i index = _mm_loadu_si128( (const __m128i*)( indexes + j ) );
+        sum0 = _mm256_fmadd_pd( _mm256_loadu_pd( values + j ), _mm256_i32gather_pd( y, index, 8 ), sum0 );
+    }
+    sum0 = _mm256_add_pd( sum0, sum1 );
+
+    // Reduction, puis elements restants
+    __m128d half = _mm_add_pd( _mm256_castpd256_pd128( sum0 ), _mm256_extractf128_pd( sum0, 1 ) );
+    double sum = _mm_cvtsd_f64( _mm_add_sd( half, _mm_unpackhi_pd( half, half ) ) );
+    for( ; j < n; ++j ) sum += values[j] * y[indexes[j]];
+
+    return( sum );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void axpyAVX2( Real* y, Real a, const Real* x, uint32_t n )
+{
+    const __m256d va = _mm256_set1_pd( a );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_pd( y + i, _mm256_fmadd_pd( va, _mm256_loadu_pd( x + i ), _mm256_loadu_pd( y + i ) ) );
+        _mm256_storeu_pd( y + i + 4,
+                          _mm256_fmadd_pd( va, _mm256_loadu_pd( x + i + 4 ), _mm256_loadu_pd( y + i + 4 ) ) );
+    }
+    for( ; i + 4 <= n; i += 4 )
+    {
+        _mm256_storeu_pd( y + i, _mm256_fmadd_pd( va, _mm256_loadu_pd( x + i ), _mm256_loadu_pd( y + i ) ) );
+    }
+    for( ; i < n; ++i ) y[i] += a * x[i];
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void axpyUpdateAVX2( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    // Les poids sont lus une seule fois : contribution a y avant leur mise a jour, puis mise a jour
+    const __m256d va = _mm256_set1_pd( a );
+    const __m256d vb = _mm256_set1_pd( b );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m256d vw = _mm256_loadu_pd( w + i );
+        _mm256_storeu_pd( y + i, _mm256_fmadd_pd( va, vw, _mm256_loadu_pd( y + i ) ) );
+        _mm256_storeu_pd( w + i, _mm256_fmadd_pd( vb, _mm256_loadu_pd( x + i ), vw ) );
+    }
+    for( ; i < n; ++i )
+    {
+        y[i] += a * w[i];
+        w[i] += b * x[i];
+    }
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void momentumAVX2( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    // Chaque poids et sa vitesse ne sont lus et ecrits qu'une seule fois
+    const __m256d vmu = _mm256_set1_pd( mu );
+    const __m256d vs = _mm256_set1_pd( s );
+    const __m256d vc = _mm256_set1_pd( c );
+    const __m256d vd = _mm256_set1_pd( d );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m256d vx = _mm256_loadu_pd( x + i );
+        const __m256d vv = _mm256_fmadd_pd( vmu, _mm256_loadu_pd( v + i ), _mm256_mul_pd( vs, vx ) );
+        _mm256_storeu_pd( v + i, vv );
+        _mm256_storeu_pd( w + i, _mm256_fmadd_pd( vd, vv, _mm256_fmadd_pd( vc, vx, _mm256_loadu_pd( w + i ) ) ) );
+    }
+    for( ; i < n; ++i )
+    {
+        v[i] = mu * v[i] + s * x[i];
+        w[i] += c * x[i] + d * v[i];
+    }
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void adamAVX2( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                      const Real* x, uint32_t n )
+{
+    // Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une seule fois
+    const Real s1 = ( 1 - beta1 ) * s;
+    const Real s2 = ( 1 - beta2 ) * s * s;
+    const __m256d vb1 = _mm256_set1_pd( beta1 );
+    const __m256d vb2 = _mm256_set1_pd( beta2 );
+    const __m256d vs1 = _mm256_set1_pd( s1 );
+    const __m256d vs2 = _mm256_set1_pd( s2 );
+    const __m256d vstep = _mm256_set1_pd( step );
+    const __m256d veps = _mm256_set1_pd( epsilon );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m256d vx = _mm256_loadu_pd( x + i );
+        const __m256d vm = _mm256_fmadd_pd( vb1, _mm256_loadu_pd( m + i ), _mm256_mul_pd( vs1, vx ) );
+        const __m256d vv = _mm256_fmadd_pd( vb2, _mm256_loadu_pd( v + i ),
+                                            _mm256_mul_pd( vs2, _mm256_mul_pd( vx, vx ) ) );
+        _mm256_storeu_pd( m + i, vm );
+        _mm256_storeu_pd( v + i, vv );
+        const __m256d delta = _mm256_div_pd( _mm256_mul_pd( vstep, vm ), _mm256_add_pd( _mm256_sqrt_pd( vv ), veps ) );
+        _mm256_storeu_pd( w + i, _mm256_sub_pd( _mm256_loadu_pd( w + i ), delta ) );
+    }
+    for( ; i < n; ++i )
+    {
+        m[i] = beta1 * m[i] + s1 * x[i];
+        v[i] = beta2 * v[i] + s2 * x[i] * x[i];
+        w[i] -= step * m[i] / ( (Real)sqrt( v[i] ) + epsilon );
+    }
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static inline __m256d expVectorAVX2( __m256d x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r, k etant arrondi a l'entier le plus proche
+    x = _mm256_min_pd( _mm256_max_pd( x, _mm256_set1_pd( EXP_MIN ) ), _mm256_set1_pd( EXP_MAX ) );
+    const __m128i k = _mm256_cvtpd_epi32( _mm256_mul_pd( x, _mm256_set1_pd( LOG2E ) ) );
+    const __m256d kd = _mm256_cvtepi32_pd( k );
+    __m256d r = _mm256_fnmadd_pd( kd, _mm256_set1_pd( LN2_HI ), x );
+    r = _mm256_fnmadd_pd( kd, _mm256_set1_pd( LN2_LO ), r );
+
+    // Polynome (schema de Horner)
+    __m256d p = _mm256_set1_pd( EXP_C7 );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( EXP_C6 ) );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( EXP_C5 ) );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( EXP_C4 ) );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( EXP_C3 ) );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( EXP_C2 ) );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( 1.0 ) );
+    p = _mm256_fmadd_pd( p, r, _mm256_set1_pd( 1.0 ) );
+
+    // 2^k construit directement dans l'exposant (k + 1023, decale de 52 bits)
+    const __m256i exponent = _mm256_cvtepi32_epi64( _mm_add_epi32( k, _mm_set1_epi32( 1023 ) ) );
+    return( _mm256_mul_pd( p, _mm256_castsi256_pd( _mm256_slli_epi64( exponent, 52 ) ) ) );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void expAVX2( Real* values, Real scale, Real shift, uint32_t n )
+{
+    const __m256d va = _mm256_set1_pd( scale );
+    const __m256d vb = _mm256_set1_pd( shift );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        _mm256_storeu_pd( values + i, expVectorAVX2( _mm256_fmadd_pd( va, _mm256_loadu_pd( values + i ), vb ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = expApprox( scale * values[i] + shift );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void sigmoidAVX2( Real* values, Real lambda, uint32_t n )
+{
+    const __m256d va = _mm256_set1_pd( -lambda );
+    const __m256d one = _mm256_set1_pd( 1.0 );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m256d e = expVectorAVX2( _mm256_mul_pd( va, _mm256_loadu_pd( values + i ) ) );
+        _mm256_storeu_pd( values + i, _mm256_div_pd( one, _mm256_add_pd( one, e ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = 1.0 / ( 1.0 + expApprox( -lambda * values[i] ) );
+}
+
+
+
+__attribute__(( target( "avx512f" ) ))
+static Real dotAVX512( const Real* x, const Real* y, uint32_t n )
+{
+    // Deux accumulateurs independants, puis elements restants traites avec un masque
+    __m512d sum0 = _mm512_setzero_pd();
+    __m512d sum1 = _mm512_setzero_pd();
+    uint32_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        sum0 = _mm512_fmadd_pd( _mm512_loadu_pd( x + i ), _mm512_loadu_pd( y + i ), sum0 );
+        sum1 = _mm512_fmadd_pd( _mm512_loadu_pd( x + i + 8 ), _mm512_loadu_pd( y + i + 8 ), sum1 );
+    }
+    for( ; i < n; i += 8 )
+    {
+        const __mmask8 mask = ( n - i >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - i ) ) - 1 ) );
+        sum0 = _mm512_fmadd_pd( _mm512_maskz_loadu_pd( mask, x + i ), _mm512_maskz_loadu_pd( mask, y + i ), sum0 );
+    }
+
+    return( _mm512_reduce_add_pd( _mm512_add_pd( sum0, sum1 ) ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static Real dotSparseAVX512( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n )
+{
+    // Elements de y charges d'apres leurs rangs (gather), deux accumulateurs independants, puis elements
+    // restants traites avec un masque
+    __m512d sum0 = _mm512_setzero_pd();
+    __m512d sum1 = _mm512_setzero_pd();
+    uint32_t j = 0;
+    for( ; j + 16 <= n; j += 16 )
+    {
+        const __m512i index = _mm512_loadu_si512( indexes + j );
+        const __m512d vy0 = _mm512_i32gather_pd( _mm512_castsi512_si256( index ), y, 8 );
+        const __m512d vy1 = _mm512_i32gather_pd( _mm512_extracti64x4_epi64( index, 1 ), y, 8 );
+        sum0 = _mm512_fmadd_pd( _mm512_loadu_pd( values + j ), vy0, sum0 );
+        sum1 = _mm512_fmadd_pd( _mm512_loadu_pd( values + j + 8 ), vy1, sum1 );
+    }
+    for( ; j < n; j += 8 )
+    {
+        const __mmask8 mask = ( n - j >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - j ) ) - 1 ) );
+        const __m256i index = _mm512_castsi512_si256( _mm512_maskz_loadu_epi32( mask, indexes + j ) );
+        const __m512d vy = _mm512_mask_i32gather_pd( _mm512_setzero_pd(), mask, index, y, 8 );
+        sum0 = _mm512_fmadd_pd( _mm512_maskz_loadu_pd( mask, values + j ), vy, sum0 );
+    }
+
+    return( _mm512_reduce_add_pd( _mm512_add_pd( sum0, sum1 ) ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void axpySparseAVX512( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n )
+{
+    // Les rangs etant distincts, les elements de y charges (gather) puis ecrits (scatter) ne se recouvrent pas
+    const __m512d va = _mm512_set1_pd( a );
+    for( uint32_t j = 0; j < n; j += 8 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = ( n - j >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - j ) ) - 1 ) );
+        const __m256i index = _mm512_castsi512_si256( _mm512_maskz_loadu_epi32( mask, indexes + j ) );
+        const __m512d vy = _mm512_mask_i32gather_pd( _mm512_setzero_pd(), mask, index, y, 8 );
+        const __m512d vx = _mm512_maskz_loadu_pd( mask, values + j );
+        _mm512_mask_i32scatter_pd( y, mask, index, _mm512_fmadd_pd( va, vx, vy ), 8 );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void axpyAVX512( Real* y, Real a, const Real* x, uint32_t n )
+{
+    const __m512d va = _mm512_set1_pd( a );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        _mm512_storeu_pd( y + i, _mm512_fmadd_pd( va, _mm512_loadu_pd( x + i ), _mm512_loadu_pd( y + i ) ) );
+    }
+    if( i < n )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = (__mmask8)( ( 1u << ( n - i ) ) - 1 );
+        const __m512d vy = _mm512_maskz_loadu_pd( mask, y + i );
+        _mm512_mask_storeu_pd( y + i, mask, _mm512_fmadd_pd( va, _mm512_maskz_loadu_pd( mask, x + i ), vy ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void axpyUpdateAVX512( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    // Les poids sont lus une seule fois : contribution a y avant leur mise a jour, puis mise a jour
+    const __m512d va = _mm512_set1_pd( a );
+    const __m512d vb = _mm512_set1_pd( b );
+    for( uint32_t i = 0; i < n; i += 8 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = ( n - i >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512d vw = _mm512_maskz_loadu_pd( mask, w + i );
+        _mm512_mask_storeu_pd( y + i, mask, _mm512_fmadd_pd( va, vw, _mm512_maskz_loadu_pd( mask, y + i ) ) );
+        _mm512_mask_storeu_pd( w + i, mask, _mm512_fmadd_pd( vb, _mm512_maskz_loadu_pd( mask, x + i ), vw ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void momentumAVX512( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    // Chaque poids et sa vitesse ne sont lus et ecrits qu'une seule fois
+    const __m512d vmu = _mm512_set1_pd( mu );
+    const __m512d vs = _mm512_set1_pd( s );
+    const __m512d vc = _mm512_set1_pd( c );
+    const __m512d vd = _mm512_set1_pd( d );
+    for( uint32_t i = 0; i < n; i += 8 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = ( n - i >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512d vx = _mm512_maskz_loadu_pd( mask, x + i );
+        const __m512d vv = _mm512_fmadd_pd( vmu, _mm512_maskz_loadu_pd( mask, v + i ), _mm512_mul_pd( vs, vx ) );
+        _mm512_mask_storeu_pd( v + i, mask, vv );
+        const __m512d vw = _mm512_fmadd_pd( vc, vx, _mm512_maskz_loadu_pd( mask, w + i ) );
+        _mm512_mask_storeu_pd( w + i, mask, _mm512_fmadd_pd( vd, vv, vw ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void adamAVX512( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                        const Real* x, uint32_t n )
+{
+    // Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une seule fois
+    const __m512d vb1 = _mm512_set1_pd( beta1 );
+    const __m512d vb2 = _mm512_set1_pd( beta2 );
+    const __m512d vs1 = _mm512_set1_pd( ( 1 - beta1 ) * s );
+    const __m512d vs2 = _mm512_set1_pd( ( 1 - beta2 ) * s * s );
+    const __m512d vstep = _mm512_set1_pd( step );
+    const __m512d veps = _mm512_set1_pd( epsilon );
+    for( uint32_t i = 0; i < n; i += 8 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = ( n - i >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512d vx = _mm512_maskz_loadu_pd( mask, x + i );
+        const __m512d vm = _mm512_fmadd_pd( vb1, _mm512_maskz_loadu_pd( mask, m + i ), _mm512_mul_pd( vs1, vx ) );
+        const __m512d vv = _mm512_fmadd_pd( vb2, _mm512_maskz_loadu_pd( mask, v + i ),
+                                            _mm512_mul_pd( vs2, _mm512_mul_pd( vx, vx ) ) );
+        _mm512_mask_storeu_pd( m + i, mask, vm );
+        _mm512_mask_storeu_pd( v + i, mask, vv );
+        const __m512d delta = _mm512_div_pd( _mm512_mul_pd( vstep, vm ), _mm512_add_pd( _mm512_sqrt_pd( vv ), veps ) );
+        _mm512_mask_storeu_pd( w + i, mask, _mm512_sub_pd( _mm512_maskz_loadu_pd( mask, w + i ), delta ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static inline __m512d expVectorAVX512( __m512d x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r, k etant arrondi a l'entier le plus proche
+    x = _mm512_min_pd( _mm512_max_pd( x, _mm512_set1_pd( EXP_MIN ) ), _mm512_set1_pd( EXP_MAX ) );
+    const __m512d k = _mm512_roundscale_pd( _mm512_mul_pd( x, _mm512_set1_pd( LOG2E ) ),
+                                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+    __m512d r = _mm512_fnmadd_pd( k, _mm512_set1_pd( LN2_HI ), x );
+    r = _mm512_fnmadd_pd( k, _mm512_set1_pd( LN2_LO ), r );
+
+    // Polynome (schema de Horner)
+    __m512d p = _mm512_set1_pd( EXP_C7 );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( EXP_C6 ) );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( EXP_C5 ) );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( EXP_C4 ) );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( EXP_C3 ) );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( EXP_C2 ) );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( 1.0 ) );
+    p = _mm512_fmadd_pd( p, r, _mm512_set1_pd( 1.0 ) );
+
+    // Multiplication par 2^k (instruction dediee)
+    return( _mm512_scalef_pd( p, k ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void expAVX512( Real* values, Real scale, Real shift, uint32_t n )
+{
+    const __m512d va = _mm512_set1_pd( scale );
+    const __m512d vb = _mm512_set1_pd( shift );
+    for( uint32_t i = 0; i < n; i += 8 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = ( n - i >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512d v = _mm512_maskz_loadu_pd( mask, values + i );
+        _mm512_mask_storeu_pd( values + i, mask, expVectorAVX512( _mm512_fmadd_pd( va, v, vb ) ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void sigmoidAVX512( Real* values, Real lambda, uint32_t n )
+{
+    const __m512d va = _mm512_set1_pd( -lambda );
+    const __m512d one = _mm512_set1_pd( 1.0 );
+    for( uint32_t i = 0; i < n; i += 8 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask8 mask = ( n - i >= 8 ? 0xFF : (__mmask8)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512d e = expVectorAVX512( _mm512_mul_pd( va, _mm512_maskz_loadu_pd( mask, values + i ) ) );
+        _mm512_mask_storeu_pd( values + i, mask, _mm512_div_pd( one, _mm512_add_pd( one, e ) ) );
+    }
+}
+
+
+static uint64_t peakSSE2( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b (SSE2 n'a pas de FMA : une multiplication et une addition)
+    const __m128d a = _mm_set1_pd( 0.75 );
+    const __m128d b = _mm_set1_pd( 0.25 );
+    __m128d x0 = _mm_setzero_pd();
+    __m128d x1 = _mm_setzero_pd();
+    __m128d x2 = _mm_setzero_pd();
+    __m128d x3 = _mm_setzero_pd();
+    __m128d x4 = _mm_setzero_pd();
+    __m128d x5 = _mm_setzero_pd();
+    __m128d x6 = _mm_setzero_pd();
+    __m128d x7 = _mm_setzero_pd();
+    __m128d x8 = _mm_setzero_pd();
+    __m128d x9 = _mm_setzero_pd();
+    __m128d x10 = _mm_setzero_pd();
+    __m128d x11 = _mm_setzero_pd();
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = _mm_add_pd( _mm_mul_pd( x0, a ), b );
+        x1 = _mm_add_pd( _mm_mul_pd( x1, a ), b );
+        x2 = _mm_add_pd( _mm_mul_pd( x2, a ), b );
+        x3 = _mm_add_pd( _mm_mul_pd( x3, a ), b );
+        x4 = _mm_add_pd( _mm_mul_pd( x4, a ), b );
+        x5 = _mm_add_pd( _mm_mul_pd( x5, a ), b );
+        x6 = _mm_add_pd( _mm_mul_pd( x6, a ), b );
+        x7 = _mm_add_pd( _mm_mul_pd( x7, a ), b );
+        x8 = _mm_add_pd( _mm_mul_pd( x8, a ), b );
+        x9 = _mm_add_pd( _mm_mul_pd( x9, a ), b );
+        x10 = _mm_add_pd( _mm_mul_pd( x10, a ), b );
+        x11 = _mm_add_pd( _mm_mul_pd( x11, a ), b );
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = _mm_add_pd( x0, x1 );
+    x2 = _mm_add_pd( x2, x3 );
+    x4 = _mm_add_pd( x4, x5 );
+    x6 = _mm_add_pd( x6, x7 );
+    x8 = _mm_add_pd( x8, x9 );
+    x10 = _mm_add_pd( x10, x11 );
+    x0 = _mm_add_pd( x0, x2 );
+    x4 = _mm_add_pd( x4, x6 );
+    x8 = _mm_add_pd( x8, x10 );
+    x0 = _mm_add_pd( x0, x4 );
+    x0 = _mm_add_pd( x0, x8 );
+    double lanes[2];
+    _mm_storeu_pd( lanes, x0 );
+    *result = lanes[0] + lanes[1];
+
+    return( 2ull * 2 * PEAK_CHAINS * nbIterations );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static uint64_t peakAVX2( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b, en nombre suffisant pour masquer la latence des FMA
+    const __m256d a = _mm256_set1_pd( 0.75 );
+    const __m256d b = _mm256_set1_pd( 0.25 );
+    __m256d x0 = _mm256_setzero_pd();
+    __m256d x1 = _mm256_setzero_pd();
+    __m256d x2 = _mm256_setzero_pd();
+    __m256d x3 = _mm256_setzero_pd();
+    __m256d x4 = _mm256_setzero_pd();
+    __m256d x5 = _mm256_setzero_pd();
+    __m256d x6 = _mm256_setzero_pd();
+    __m256d x7 = _mm256_setzero_pd();
+    __m256d x8 = _mm256_setzero_pd();
+    __m256d x9 = _mm256_setzero_pd();
+    __m256d x10 = _mm256_setzero_pd();
+    __m256d x11 = _mm256_setzero_pd();
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = _mm256_fmadd_pd( x0, a, b );
+        x1 = _mm256_fmadd_pd( x1, a, b );
+        x2 = _mm256_fmadd_pd( x2, a, b );
+        x3 = _mm256_fmadd_pd( x3, a, b );
+        x4 = _mm256_fmadd_pd( x4, a, b );
+        x5 = _mm256_fmadd_pd( x5, a, b );
+        x6 = _mm256_fmadd_pd( x6, a, b );
+        x7 = _mm256_fmadd_pd( x7, a, b );
+        x8 = _mm256_fmadd_pd( x8, a, b );
+        x9 = _mm256_fmadd_pd( x9, a, b );
+        x10 = _mm256_fmadd_pd( x10, a, b );
+        x11 = _mm256_fmadd_pd( x11, a, b );
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = _mm256_add_pd( x0, x1 );
+    x2 = _mm256_add_pd( x2, x3 );
+    x4 = _mm256_add_pd( x4, x5 );
+    x6 = _mm256_add_pd( x6, x7 );
+    x8 = _mm256_add_pd( x8, x9 );
+    x10 = _mm256_add_pd( x10, x11 );
+    x0 = _mm256_add_pd( x0, x2 );
+    x4 = _mm256_add_pd( x4, x6 );
+    x8 = _mm256_add_pd( x8, x10 );
+    x0 = _mm256_add_pd( x0, x4 );
+    x0 = _mm256_add_pd( x0, x8 );
+    double lanes[4];
+    _mm256_storeu_pd( lanes, x0 );
+    *result = 0;
+    for( uint32_t i = 0; i < 4; ++i ) *result += lanes[i];
+
+    return( 2ull * 4 * PEAK_CHAINS * nbIterations );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static uint64_t peakAVX512( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b, en nombre suffisant pour masquer la latence des FMA
+    const __m512d a = _mm512_set1_pd( 0.75 );
+    const __m512d b = _mm512_set1_pd( 0.25 );
+    __m512d x0 = _mm512_setzero_pd();
+    __m512d x1 = _mm512_setzero_pd();
+    __m512d x2 = _mm512_setzero_pd();
+    __m512d x3 = _mm512_setzero_pd();
+    __m512d x4 = _mm512_setzero_pd();
+    __m512d x5 = _mm512_setzero_pd();
+    __m512d x6 = _mm512_setzero_pd();
+    __m512d x7 = _mm512_setzero_pd();
+    __m512d x8 = _mm512_setzero_pd();
+    __m512d x9 = _mm512_setzero_pd();
+    __m512d x10 = _mm512_setzero_pd();
+    __m512d x11 = _mm512_setzero_pd();
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = _mm512_fmadd_pd( x0, a, b );
+        x1 = _mm512_fmadd_pd( x1, a, b );
+        x2 = _mm512_fmadd_pd( x2, a, b );
+        x3 = _mm512_fmadd_pd( x3, a, b );
+        x4 = _mm512_fmadd_pd( x4, a, b );
+        x5 = _mm512_fmadd_pd( x5, a, b );
+        x6 = _mm512_fmadd_pd( x6, a, b );
+        x7 = _mm512_fmadd_pd( x7, a, b );
+        x8 = _mm512_fmadd_pd( x8, a, b );
+        x9 = _mm512_fmadd_pd( x9, a, b );
+        x10 = _mm512_fmadd_pd( x10, a, b );
+        x11 = _mm512_fmadd_pd( x11, a, b );
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = _mm512_add_pd( x0, x1 );
+    x2 = _mm512_add_pd( x2, x3 );
+    x4 = _mm512_add_pd( x4, x5 );
+    x6 = _mm512_add_pd( x6, x7 );
+    x8 = _mm512_add_pd( x8, x9 );
+    x10 = _mm512_add_pd( x10, x11 );
+    x0 = _mm512_add_pd( x0, x2 );
+    x4 = _mm512_add_pd( x4, x6 );
+    x8 = _mm512_add_pd( x8, x10 );
+    x0 = _mm512_add_pd( x0, x4 );
+    x0 = _mm512_add_pd( x0, x8 );
+    *result = _mm512_reduce_add_pd( x0 );
+
+    return( 2ull * 8 * PEAK_CHAINS * nbIterations );
+}
+
+
+#elif defined( KERNEL_X86 )
+
+// Noyaux simple precision
+
+static Real dotSSE2( const Real* x, const Real* y, uint32_t n )
+{
+    // Deux accumulateurs independants pour masquer la latence des additions
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( x + i ), _mm_loadu_ps( y + i ) ) );
+        sum1 = _mm_add_ps( sum1, _mm_mul_ps( _mm_loadu_ps( x + i + 4 ), _mm_loadu_ps( y + i + 4 ) ) );
+    }
+    sum0 = _mm_add_ps( sum0, sum1 );
+
+    // Reduction, puis elements restants
+    sum0 = _mm_add_ps( sum0, _mm_movehl_ps( sum0, sum0 ) );
+    float sum = _mm_cvtss_f32( _mm_add_ss( sum0, _mm_shuffle_ps( sum0, sum0, 1 ) ) );
+    for( ; i < n; ++i ) sum += x[i] * y[i];
+
+    return( sum );
+}
+
+
+static void axpySSE2( Real* y, Real a, const Real* x, uint32_t n )
+{
+    const __m128 va = _mm_set1_ps( a );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( y + i, _mm_add_ps( _mm_loadu_ps( y + i ), _mm_mul_ps( va, _mm_loadu_ps( x + i ) ) ) );
+    }
+    for( ; i < n; ++i ) y[i] += a * x[i];
+}
+
+
+static void axpyUpdateSSE2( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    // Les poids sont lus une seule fois : contribution a y avant leur mise a jour, puis mise a jour
+    const __m128 va = _mm_set1_ps( a );
+    const __m128 vb = _mm_set1_ps( b );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 vw = _mm_loadu_ps( w + i );
+        _mm_storeu_ps( y + i, _mm_add_ps( _mm_loadu_ps( y + i ), _mm_mul_ps( va, vw ) ) );
+        _mm_storeu_ps( w + i, _mm_add_ps( vw, _mm_mul_ps( vb, _mm_loadu_ps( x + i ) ) ) );
+    }
+    for( ; i < n; ++i )
+    {
+        y[i] += a * w[i];
+        w[i] += b * x[i];
+    }
+}
+
+
+static void momentumSSE2( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    // Chaque poids et sa vitesse ne sont lus et ecrits qu'une seule fois
+    const __m128 vmu = _mm_set1_ps( mu );
+    const __m128 vs = _mm_set1_ps( s );
+    const __m128 vc = _mm_set1_ps( c );
+    const __m128 vd = _mm_set1_ps( d );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 vx = _mm_loadu_ps( x + i );
+        const __m128 vv = _mm_add_ps( _mm_mul_ps( vmu, _mm_loadu_ps( v + i ) ), _mm_mul_ps( vs, vx ) );
+        _mm_storeu_ps( v + i, vv );
+        _mm_storeu_ps( w + i, _mm_add_ps( _mm_add_ps( _mm_loadu_ps( w + i ), _mm_mul_ps( vc, vx ) ),
+                                          _mm_mul_ps( vd, vv ) ) );
+    }
+    for( ; i < n; ++i )
+    {
+        v[i] = mu * v[i] + s * x[i];
+        w[i] += c * x[i] + d * v[i];
+    }
+}
+
+
+static void adamSSE2( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                      const Real* x, uint32_t n )
+{
+    // Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une seule fois
+    const Real s1 = ( 1 - beta1 ) * s;
+    const Real s2 = ( 1 - beta2 ) * s * s;
+    const __m128 vb1 = _mm_set1_ps( beta1 );
+    const __m128 vb2 = _mm_set1_ps( beta2 );
+    const __m128 vs1 = _mm_set1_ps( s1 );
+    const __m128 vs2 = _mm_set1_ps( s2 );
+    const __m128 vstep = _mm_set1_ps( step );
+    const __m128 veps = _mm_set1_ps( epsilon );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 vx = _mm_loadu_ps( x + i );
+        const __m128 vm = _mm_add_ps( _mm_mul_ps( vb1, _mm_loadu_ps( m + i ) ), _mm_mul_ps( vs1, vx ) );
+        const __m128 vv = _mm_add_ps( _mm_mul_ps( vb2, _mm_loadu_ps( v + i ) ),
+                                      _mm_mul_ps( vs2, _mm_mul_ps( vx, vx ) ) );
+        _mm_storeu_ps( m + i, vm );
+        _mm_storeu_ps( v + i, vv );
+        const __m128 delta = _mm_div_ps( _mm_mul_ps( vstep, vm ), _mm_add_ps( _mm_sqrt_ps( vv ), veps ) );
+        _mm_storeu_ps( w + i, _mm_sub_ps( _mm_loadu_ps( w + i ), delta ) );
+    }
+    for( ; i < n; ++i )
+    {
+        m[i] = beta1 * m[i] + s1 * x[i];
+        v[i] = beta2 * v[i] + s2 * x[i] * x[i];
+        w[i] -= step * m[i] / ( (Real)sqrt( v[i] ) + epsilon );
+    }
+}
+
+
+static inline __m128 expVectorSSE2( __m128 x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r, k etant arrondi a l'entier le plus proche
+    x = _mm_min_ps( _mm_max_ps( x, _mm_set1_ps( EXP_MIN ) ), _mm_set1_ps( EXP_MAX ) );
+    const __m128i k = _mm_cvtps_epi32( _mm_mul_ps( x, _mm_set1_ps( LOG2E ) ) );
+    const __m128 kd = _mm_cvtepi32_ps( k );
+    const __m128 r = _mm_sub_ps( _mm_sub_ps( x, _mm_mul_ps( kd, _mm_set1_ps( LN2_HI ) ) ),
+                                 _mm_mul_ps( kd, _mm_set1_ps( LN2_LO ) ) );
+
+    // Polynome (schema de Horner)
+    __m128 p = _mm_set1_ps( EXP_C7 );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_C6 ) );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_C5 ) );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_C4 ) );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_C3 ) );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_C2 ) );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( 1.0 ) );
+    p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( 1.0 ) );
+
+    // 2^k construit directement dans l'exposant (k + 127, decale de 23 bits)
+    const __m128i exponent = _mm_add_epi32( k, _mm_set1_epi32( 127 ) );
+    return( _mm_mul_ps( p, _mm_castsi128_ps( _mm_slli_epi32( exponent, 23 ) ) ) );
+}
+
+
+static void expSSE2( Real* values, Real scale, Real shift, uint32_t n )
+{
+    const __m128 va = _mm_set1_ps( scale );
+    const __m128 vb = _mm_set1_ps( shift );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( values + i, expVectorSSE2( _mm_add_ps( _mm_mul_ps( va, _mm_loadu_ps( values + i ) ), vb ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = expApprox( scale * values[i] + shift );
+}
+
+
+static void sigmoidSSE2( Real* values, Real lambda, uint32_t n )
+{
+    const __m128 va = _mm_set1_ps( -lambda );
+    const __m128 one = _mm_set1_ps( 1.0 );
+    uint32_t i = 0;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128 e = expVectorSSE2( _mm_mul_ps( va, _mm_loadu_ps( values + i ) ) );
+        _mm_storeu_ps( values + i, _mm_div_ps( one, _mm_add_ps( one, e ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = 1.0 / ( 1.0 + expApprox( -lambda * values[i] ) );
+}
+
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static Real dotAVX2( const Real* x, const Real* y, uint32_t n )
+{
+    // Quatre accumulateurs independants pour masquer la latence des FMA
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+    __m256 sum3 = _mm256_setzero_ps();
+    uint32_t i = 0;
+    for( ; i + 32 <= n; i += 32 )
+    {
+        sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( x + i ), _mm256_loadu_ps( y + i ), sum0 );
+        sum1 = _mm256_fmadd_ps( _mm256_loadu_ps( x + i + 8 ), _mm256_loadu_ps( y + i + 8 ), sum1 );
+        sum2 = _mm256_fmadd_ps( _mm256_loadu_ps( x + i + 16 ), _mm256_loadu_ps( y + i + 16 ), sum2 );
+        sum3 = _mm256_fmadd_ps( _mm256_loadu_ps( x + i + 24 ), _mm256_loadu_ps( y + i + 24 ), sum3 );
+    }
+    for( ; i + 8 <= n; i += 8 )
+    {
+        sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( x + i ), _mm256_loadu_ps( y + i ), sum0 );
+    }
+    sum0 = _mm256_add_ps( _mm256_add_ps( sum0, sum1 ), _mm256_add_ps( sum2, sum3 ) );
+
+    // Reduction, puis elements restants
+    __m128 half = _mm_add_ps( _mm256_castps256_ps128( sum0 ), _mm256_extractf128_ps( sum0, 1 ) );
+    half = _mm_add_ps( half, _mm_movehl_ps( half, half ) );
+    float sum = _mm_cvtss_f32( _mm_add_ss( half, _mm_shuffle_ps( half, half, 1 ) ) );
+    for( ; i < n; ++i ) sum += x[i] * y[i];
+
+    return( sum );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static Real dotSparseAVX2( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n )
+{
+    // Elements de y charges d'apres leurs rangs (gather), deux accumulateurs independants
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    uint32_t j = 0;
+    for( ; j + 16 <= n; j += 16 )
+    {
+        const __m256i index0 = _mm256_loadu_si256( (const __m256i*)( indexes + j ) );
+        const __m256i index1 = _mm256_loadu_si256( (const __m256i*)( indexes + j + 8 ) );
+        sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( values + j ), _mm256_i32gather_ps( y, index0, 4 ), sum0 );
+        sum1 = _mm256_fmadd_ps( _mm256_loadu_ps( values + j + 8 ), _mm256_i32gather_ps( y, index1, 4 ), sum1 );
+    }
+    for( ; j + 8 <= n; j += 8 )
+    {
+        const __m256i index = _mm256_loadu_si256( (const __m256i*)( indexes + j ) );
+        sum0 = _mm256_fmadd_ps( _mm256_loadu_ps( values + j ), _mm256_i32gather_ps( y, index, 4 ), sum0 );
+    }
+    sum0 = _mm256_add_ps( sum0, sum1 );
+
+    // Reduction, puis elements restants
+    __m128 half = _mm_add_ps( _mm256_castps256_ps128( sum0 ), _mm256_extractf128_ps( sum0, 1 ) );
+    half = _mm_add_ps( half, _mm_movehl_ps( half, half ) );
+    float sum = _mm_cvtss_f32( _mm_add_ss( half, _mm_shuffle_ps( half, half, 1 ) ) );
+    for( ; j < n; ++j ) sum += values[j] * y[indexes[j]];
+
+    return( sum );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void axpyAVX2( Real* y, Real a, const Real* x, uint32_t n )
+{
+    const __m256 va = _mm256_set1_ps( a );
+    uint32_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        _mm256_storeu_ps( y + i, _mm256_fmadd_ps( va, _mm256_loadu_ps( x + i ), _mm256_loadu_ps( y + i ) ) );
+        _mm256_storeu_ps( y + i + 8,
+                          _mm256_fmadd_ps( va, _mm256_loadu_ps( x + i + 8 ), _mm256_loadu_ps( y + i + 8 ) ) );
+    }
+    for( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( y + i, _mm256_fmadd_ps( va, _mm256_loadu_ps( x + i ), _mm256_loadu_ps( y + i ) ) );
+    }
+    for( ; i < n; ++i ) y[i] += a * x[i];
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void axpyUpdateAVX2( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    // Les poids sont lus une seule fois : contribution a y avant leur mise a jour, puis mise a jour
+    const __m256 va = _mm256_set1_ps( a );
+    const __m256 vb = _mm256_set1_ps( b );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 vw = _mm256_loadu_ps( w + i );
+        _mm256_storeu_ps( y + i, _mm256_fmadd_ps( va, vw, _mm256_loadu_ps( y + i ) ) );
+        _mm256_storeu_ps( w + i, _mm256_fmadd_ps( vb, _mm256_loadu_ps( x + i ), vw ) );
+    }
+    for( ; i < n; ++i )
+    {
+        y[i] += a * w[i];
+        w[i] += b * x[i];
+    }
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void momentumAVX2( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    // Chaque poids et sa vitesse ne sont lus et ecrits qu'une seule fois
+    const __m256 vmu = _mm256_set1_ps( mu );
+    const __m256 vs = _mm256_set1_ps( s );
+    const __m256 vc = _mm256_set1_ps( c );
+    const __m256 vd = _mm256_set1_ps( d );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 vx = _mm256_loadu_ps( x + i );
+        const __m256 vv = _mm256_fmadd_ps( vmu, _mm256_loadu_ps( v + i ), _mm256_mul_ps( vs, vx ) );
+        _mm256_storeu_ps( v + i, vv );
+        _mm256_storeu_ps( w + i, _mm256_fmadd_ps( vd, vv, _mm256_fmadd_ps( vc, vx, _mm256_loadu_ps( w + i ) ) ) );
+    }
+    for( ; i < n; ++i )
+    {
+        v[i] = mu * v[i] + s * x[i];
+        w[i] += c * x[i] + d * v[i];
+    }
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void adamAVX2( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                      const Real* x, uint32_t n )
+{
+    // Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une seule fois
+    const Real s1 = ( 1 - beta1 ) * s;
+    const Real s2 = ( 1 - beta2 ) * s * s;
+    const __m256 vb1 = _mm256_set1_ps( beta1 );
+    const __m256 vb2 = _mm256_set1_ps( beta2 );
+    const __m256 vs1 = _mm256_set1_ps( s1 );
+    const __m256 vs2 = _mm256_set1_ps( s2 );
+    const __m256 vstep = _mm256_set1_ps( step );
+    const __m256 veps = _mm256_set1_ps( epsilon );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 vx = _mm256_loadu_ps( x + i );
+        const __m256 vm = _mm256_fmadd_ps( vb1, _mm256_loadu_ps( m + i ), _mm256_mul_ps( vs1, vx ) );
+        const __m256 vv = _mm256_fmadd_ps( vb2, _mm256_loadu_ps( v + i ),
+                                          _mm256_mul_ps( vs2, _mm256_mul_ps( vx, vx ) ) );
+        _mm256_storeu_ps( m + i, vm );
+        _mm256_storeu_ps( v + i, vv );
+        const __m256 delta = _mm256_div_ps( _mm256_mul_ps( vstep, vm ), _mm256_add_ps( _mm256_sqrt_ps( vv ), veps ) );
+        _mm256_storeu_ps( w + i, _mm256_sub_ps( _mm256_loadu_ps( w + i ), delta ) );
+    }
+    for( ; i < n; ++i )
+    {
+        m[i] = beta1 * m[i] + s1 * x[i];
+        v[i] = beta2 * v[i] + s2 * x[i] * x[i];
+        w[i] -= step * m[i] / ( (Real)sqrt( v[i] ) + epsilon );
+    }
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static inline __m256 expVectorAVX2( __m256 x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r, k etant arrondi a l'entier le plus proche
+    x = _mm256_min_ps( _mm256_max_ps( x, _mm256_set1_ps( EXP_MIN ) ), _mm256_set1_ps( EXP_MAX ) );
+    const __m256i k = _mm256_cvtps_epi32( _mm256_mul_ps( x, _mm256_set1_ps( LOG2E ) ) );
+    const __m256 kd = _mm256_cvtepi32_ps( k );
+    __m256 r = _mm256_fnmadd_ps( kd, _mm256_set1_ps( LN2_HI ), x );
+    r = _mm256_fnmadd_ps( kd, _mm256_set1_ps( LN2_LO ), r );
+
+    // Polynome (schema de Horner)
+    __m256 p = _mm256_set1_ps( EXP_C7 );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( EXP_C6 ) );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( EXP_C5 ) );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( EXP_C4 ) );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( EXP_C3 ) );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( EXP_C2 ) );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( 1.0 ) );
+    p = _mm256_fmadd_ps( p, r, _mm256_set1_ps( 1.0 ) );
+
+    // 2^k construit directement dans l'exposant (k + 127, decale de 23 bits)
+    const __m256i exponent = _mm256_add_epi32( k, _mm256_set1_epi32( 127 ) );
+    return( _mm256_mul_ps( p, _mm256_castsi256_ps( _mm256_slli_epi32( exponent, 23 ) ) ) );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void expAVX2( Real* values, Real scale, Real shift, uint32_t n )
+{
+    const __m256 va = _mm256_set1_ps( scale );
+    const __m256 vb = _mm256_set1_ps( shift );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( values + i, expVectorAVX2( _mm256_fmadd_ps( va, _mm256_loadu_ps( values + i ), vb ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = expApprox( scale * values[i] + shift );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static void sigmoidAVX2( Real* values, Real lambda, uint32_t n )
+{
+    const __m256 va = _mm256_set1_ps( -lambda );
+    const __m256 one = _mm256_set1_ps( 1.0 );
+    uint32_t i = 0;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        const __m256 e = expVectorAVX2( _mm256_mul_ps( va, _mm256_loadu_ps( values + i ) ) );
+        _mm256_storeu_ps( values + i, _mm256_div_ps( one, _mm256_add_ps( one, e ) ) );
+    }
+    for( ; i < n; ++i ) values[i] = 1.0 / ( 1.0 + expApprox( -lambda * values[i] ) );
+}
+
+
+
+__attribute__(( target( "avx512f" ) ))
+static Real dotAVX512( const Real* x, const Real* y, uint32_t n )
+{
+    // Deux accumulateurs independants, puis elements restants traites avec un masque
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    uint32_t i = 0;
+    for( ; i + 32 <= n; i += 32 )
+    {
+        sum0 = _mm512_fmadd_ps( _mm512_loadu_ps( x + i ), _mm512_loadu_ps( y + i ), sum0 );
+        sum1 = _mm512_fmadd_ps( _mm512_loadu_ps( x + i + 16 ), _mm512_loadu_ps( y + i + 16 ), sum1 );
+    }
+    for( ; i < n; i += 16 )
+    {
+        const __mmask16 mask = ( n - i >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - i ) ) - 1 ) );
+        sum0 = _mm512_fmadd_ps( _mm512_maskz_loadu_ps( mask, x + i ), _mm512_maskz_loadu_ps( mask, y + i ), sum0 );
+    }
+
+    return( _mm512_reduce_add_ps( _mm512_add_ps( sum0, sum1 ) ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static Real dotSparseAVX512( const Real* values, const uint32_t* indexes, const Real* y, uint32_t n )
+{
+    // Elements de y charges d'apres leurs rangs (gather), deux accumulateurs independants, puis elements
+    // restants traites avec un masque
+    __m512 sum0 = _mm512_setzero_ps();
+    __m512 sum1 = _mm512_setzero_ps();
+    uint32_t j = 0;
+    for( ; j + 32 <= n; j += 32 )
+    {
+        const __m512i index0 = _mm512_loadu_si512( indexes + j );
+        const __m512i index1 = _mm512_loadu_si512( indexes + j + 16 );
+        sum0 = _mm512_fmadd_ps( _mm512_loadu_ps( values + j ), _mm512_i32gather_ps( index0, y, 4 ), sum0 );
+        sum1 = _mm512_fmadd_ps( _mm512_loadu_ps( values + j + 16 ), _mm512_i32gather_ps( index1, y, 4 ), sum1 );
+    }
+    for( ; j < n; j += 16 )
+    {
+        const __mmask16 mask = ( n - j >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - j ) ) - 1 ) );
+        const __m512i index = _mm512_maskz_loadu_epi32( mask, indexes + j );
+        const __m512 vy = _mm512_mask_i32gather_ps( _mm512_setzero_ps(), mask, index, y, 4 );
+        sum0 = _mm512_fmadd_ps( _mm512_maskz_loadu_ps( mask, values + j ), vy, sum0 );
+    }
+
+    return( _mm512_reduce_add_ps( _mm512_add_ps( sum0, sum1 ) ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void axpySparseAVX512( Real* y, Real a, const Real* values, const uint32_t* indexes, uint32_t n )
+{
+    // Les rangs etant distincts, les elements de y charges (gather) puis ecrits (scatter) ne se recouvrent pas
+    const __m512 va = _mm512_set1_ps( a );
+    for( uint32_t j = 0; j < n; j += 16 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = ( n - j >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - j ) ) - 1 ) );
+        const __m512i index = _mm512_maskz_loadu_epi32( mask, indexes + j );
+        const __m512 vy = _mm512_mask_i32gather_ps( _mm512_setzero_ps(), mask, index, y, 4 );
+        const __m512 vx = _mm512_maskz_loadu_ps( mask, values + j );
+        _mm512_mask_i32scatter_ps( y, mask, index, _mm512_fmadd_ps( va, vx, vy ), 4 );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void axpyAVX512( Real* y, Real a, const Real* x, uint32_t n )
+{
+    const __m512 va = _mm512_set1_ps( a );
+    uint32_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        _mm512_storeu_ps( y + i, _mm512_fmadd_ps( va, _mm512_loadu_ps( x + i ), _mm512_loadu_ps( y + i ) ) );
+    }
+    if( i < n )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = (__mmask16)( ( 1u << ( n - i ) ) - 1 );
+        const __m512 vy = _mm512_maskz_loadu_ps( mask, y + i );
+        _mm512_mask_storeu_ps( y + i, mask, _mm512_fmadd_ps( va, _mm512_maskz_loadu_ps( mask, x + i ), vy ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void axpyUpdateAVX512( Real* y, Real a, Real* w, Real b, const Real* x, uint32_t n )
+{
+    // Les poids sont lus une seule fois : contribution a y avant leur mise a jour, puis mise a jour
+    const __m512 va = _mm512_set1_ps( a );
+    const __m512 vb = _mm512_set1_ps( b );
+    for( uint32_t i = 0; i < n; i += 16 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = ( n - i >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512 vw = _mm512_maskz_loadu_ps( mask, w + i );
+        _mm512_mask_storeu_ps( y + i, mask, _mm512_fmadd_ps( va, vw, _mm512_maskz_loadu_ps( mask, y + i ) ) );
+        _mm512_mask_storeu_ps( w + i, mask, _mm512_fmadd_ps( vb, _mm512_maskz_loadu_ps( mask, x + i ), vw ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void momentumAVX512( Real* w, Real* v, Real mu, Real s, Real c, Real d, const Real* x, uint32_t n )
+{
+    // Chaque poids et sa vitesse ne sont lus et ecrits qu'une seule fois
+    const __m512 vmu = _mm512_set1_ps( mu );
+    const __m512 vs = _mm512_set1_ps( s );
+    const __m512 vc = _mm512_set1_ps( c );
+    const __m512 vd = _mm512_set1_ps( d );
+    for( uint32_t i = 0; i < n; i += 16 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = ( n - i >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512 vx = _mm512_maskz_loadu_ps( mask, x + i );
+        const __m512 vv = _mm512_fmadd_ps( vmu, _mm512_maskz_loadu_ps( mask, v + i ), _mm512_mul_ps( vs, vx ) );
+        _mm512_mask_storeu_ps( v + i, mask, vv );
+        const __m512 vw = _mm512_fmadd_ps( vc, vx, _mm512_maskz_loadu_ps( mask, w + i ) );
+        _mm512_mask_storeu_ps( w + i, mask, _mm512_fmadd_ps( vd, vv, vw ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void adamAVX512( Real* w, Real* m, Real* v, Real beta1, Real beta2, Real s, Real step, Real epsilon,
+                        const Real* x, uint32_t n )
+{
+    // Chaque poids et ses deux moyennes ne sont lus et ecrits qu'une seule fois
+    const __m512 vb1 = _mm512_set1_ps( beta1 );
+    const __m512 vb2 = _mm512_set1_ps( beta2 );
+    const __m512 vs1 = _mm512_set1_ps( ( 1 - beta1 ) * s );
+    const __m512 vs2 = _mm512_set1_ps( ( 1 - beta2 ) * s * s );
+    const __m512 vstep = _mm512_set1_ps( step );
+    const __m512 veps = _mm512_set1_ps( epsilon );
+    for( uint32_t i = 0; i < n; i += 16 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = ( n - i >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512 vx = _mm512_maskz_loadu_ps( mask, x + i );
+        const __m512 vm = _mm512_fmadd_ps( vb1, _mm512_maskz_loadu_ps( mask, m + i ), _mm512_mul_ps( vs1, vx ) );
+        const __m512 vv = _mm512_fmadd_ps( vb2, _mm512_maskz_loadu_ps( mask, v + i ),
+                                           _mm512_mul_ps( vs2, _mm512_mul_ps( vx, vx ) ) );
+        _mm512_mask_storeu_ps( m + i, mask, vm );
+        _mm512_mask_storeu_ps( v + i, mask, vv );
+        const __m512 delta = _mm512_div_ps( _mm512_mul_ps( vstep, vm ), _mm512_add_ps( _mm512_sqrt_ps( vv ), veps ) );
+        _mm512_mask_storeu_ps( w + i, mask, _mm512_sub_ps( _mm512_maskz_loadu_ps( mask, w + i ), delta ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static inline __m512 expVectorAVX512( __m512 x )
+{
+    // Reduction de l'argument (borne) : x = k.ln2 + r, k etant arrondi a l'entier le plus proche
+    x = _mm512_min_ps( _mm512_max_ps( x, _mm512_set1_ps( EXP_MIN ) ), _mm512_set1_ps( EXP_MAX ) );
+    const __m512 k = _mm512_roundscale_ps( _mm512_mul_ps( x, _mm512_set1_ps( LOG2E ) ),
+                                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+    __m512 r = _mm512_fnmadd_ps( k, _mm512_set1_ps( LN2_HI ), x );
+    r = _mm512_fnmadd_ps( k, _mm512_set1_ps( LN2_LO ), r );
+
+    // Polynome (schema de Horner)
+    __m512 p = _mm512_set1_ps( EXP_C7 );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( EXP_C6 ) );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( EXP_C5 ) );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( EXP_C4 ) );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( EXP_C3 ) );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( EXP_C2 ) );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( 1.0 ) );
+    p = _mm512_fmadd_ps( p, r, _mm512_set1_ps( 1.0 ) );
+
+    // Multiplication par 2^k (instruction dediee)
+    return( _mm512_scalef_ps( p, k ) );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void expAVX512( Real* values, Real scale, Real shift, uint32_t n )
+{
+    const __m512 va = _mm512_set1_ps( scale );
+    const __m512 vb = _mm512_set1_ps( shift );
+    for( uint32_t i = 0; i < n; i += 16 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = ( n - i >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512 v = _mm512_maskz_loadu_ps( mask, values + i );
+        _mm512_mask_storeu_ps( values + i, mask, expVectorAVX512( _mm512_fmadd_ps( va, v, vb ) ) );
+    }
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static void sigmoidAVX512( Real* values, Real lambda, uint32_t n )
+{
+    const __m512 va = _mm512_set1_ps( -lambda );
+    const __m512 one = _mm512_set1_ps( 1.0 );
+    for( uint32_t i = 0; i < n; i += 16 )
+    {
+        // Elements restants traites avec un masque
+        const __mmask16 mask = ( n - i >= 16 ? 0xFFFF : (__mmask16)( ( 1u << ( n - i ) ) - 1 ) );
+        const __m512 e = expVectorAVX512( _mm512_mul_ps( va, _mm512_maskz_loadu_ps( mask, values + i ) ) );
+        _mm512_mask_storeu_ps( values + i, mask, _mm512_div_ps( one, _mm512_add_ps( one, e ) ) );
+    }
+}
+
+
+
+static uint64_t peakSSE2( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b (SSE2 n'a pas de FMA : une multiplication et une addition)
+    const __m128 a = _mm_set1_ps( 0.75f );
+    const __m128 b = _mm_set1_ps( 0.25f );
+    __m128 x0 = _mm_setzero_ps();
+    __m128 x1 = _mm_setzero_ps();
+    __m128 x2 = _mm_setzero_ps();
+    __m128 x3 = _mm_setzero_ps();
+    __m128 x4 = _mm_setzero_ps();
+    __m128 x5 = _mm_setzero_ps();
+    __m128 x6 = _mm_setzero_ps();
+    __m128 x7 = _mm_setzero_ps();
+    __m128 x8 = _mm_setzero_ps();
+    __m128 x9 = _mm_setzero_ps();
+    __m128 x10 = _mm_setzero_ps();
+    __m128 x11 = _mm_setzero_ps();
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = _mm_add_ps( _mm_mul_ps( x0, a ), b );
+        x1 = _mm_add_ps( _mm_mul_ps( x1, a ), b );
+        x2 = _mm_add_ps( _mm_mul_ps( x2, a ), b );
+        x3 = _mm_add_ps( _mm_mul_ps( x3, a ), b );
+        x4 = _mm_add_ps( _mm_mul_ps( x4, a ), b );
+        x5 = _mm_add_ps( _mm_mul_ps( x5, a ), b );
+        x6 = _mm_add_ps( _mm_mul_ps( x6, a ), b );
+        x7 = _mm_add_ps( _mm_mul_ps( x7, a ), b );
+        x8 = _mm_add_ps( _mm_mul_ps( x8, a ), b );
+        x9 = _mm_add_ps( _mm_mul_ps( x9, a ), b );
+        x10 = _mm_add_ps( _mm_mul_ps( x10, a ), b );
+        x11 = _mm_add_ps( _mm_mul_ps( x11, a ), b );
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = _mm_add_ps( x0, x1 );
+    x2 = _mm_add_ps( x2, x3 );
+    x4 = _mm_add_ps( x4, x5 );
+    x6 = _mm_add_ps( x6, x7 );
+    x8 = _mm_add_ps( x8, x9 );
+    x10 = _mm_add_ps( x10, x11 );
+    x0 = _mm_add_ps( x0, x2 );
+    x4 = _mm_add_ps( x4, x6 );
+    x8 = _mm_add_ps( x8, x10 );
+    x0 = _mm_add_ps( x0, x4 );
+    x0 = _mm_add_ps( x0, x8 );
+    float lanes[4];
+    _mm_storeu_ps( lanes, x0 );
+    *result = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+
+    return( 2ull * 4 * PEAK_CHAINS * nbIterations );
+}
+
+
+__attribute__(( target( "avx2,fma" ) ))
+static uint64_t peakAVX2( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b, en nombre suffisant pour masquer la latence des FMA
+    const __m256 a = _mm256_set1_ps( 0.75f );
+    const __m256 b = _mm256_set1_ps( 0.25f );
+    __m256 x0 = _mm256_setzero_ps();
+    __m256 x1 = _mm256_setzero_ps();
+    __m256 x2 = _mm256_setzero_ps();
+    __m256 x3 = _mm256_setzero_ps();
+    __m256 x4 = _mm256_setzero_ps();
+    __m256 x5 = _mm256_setzero_ps();
+    __m256 x6 = _mm256_setzero_ps();
+    __m256 x7 = _mm256_setzero_ps();
+    __m256 x8 = _mm256_setzero_ps();
+    __m256 x9 = _mm256_setzero_ps();
+    __m256 x10 = _mm256_setzero_ps();
+    __m256 x11 = _mm256_setzero_ps();
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = _mm256_fmadd_ps( x0, a, b );
+        x1 = _mm256_fmadd_ps( x1, a, b );
+        x2 = _mm256_fmadd_ps( x2, a, b );
+        x3 = _mm256_fmadd_ps( x3, a, b );
+        x4 = _mm256_fmadd_ps( x4, a, b );
+        x5 = _mm256_fmadd_ps( x5, a, b );
+        x6 = _mm256_fmadd_ps( x6, a, b );
+        x7 = _mm256_fmadd_ps( x7, a, b );
+        x8 = _mm256_fmadd_ps( x8, a, b );
+        x9 = _mm256_fmadd_ps( x9, a, b );
+        x10 = _mm256_fmadd_ps( x10, a, b );
+        x11 = _mm256_fmadd_ps( x11, a, b );
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = _mm256_add_ps( x0, x1 );
+    x2 = _mm256_add_ps( x2, x3 );
+    x4 = _mm256_add_ps( x4, x5 );
+    x6 = _mm256_add_ps( x6, x7 );
+    x8 = _mm256_add_ps( x8, x9 );
+    x10 = _mm256_add_ps( x10, x11 );
+    x0 = _mm256_add_ps( x0, x2 );
+    x4 = _mm256_add_ps( x4, x6 );
+    x8 = _mm256_add_ps( x8, x10 );
+    x0 = _mm256_add_ps( x0, x4 );
+    x0 = _mm256_add_ps( x0, x8 );
+    float lanes[8];
+    _mm256_storeu_ps( lanes, x0 );
+    *result = 0;
+    for( uint32_t i = 0; i < 8; ++i ) *result += lanes[i];
+
+    return( 2ull * 8 * PEAK_CHAINS * nbIterations );
+}
+
+
+__attribute__(( target( "avx512f" ) ))
+static uint64_t peakAVX512( uint32_t nbIterations, Real* result )
+{
+    // Chaines independantes x = a.x + b, en nombre suffisant pour masquer la latence des FMA
+    const __m512 a = _mm512_set1_ps( 0.75f );
+    const __m512 b = _mm512_set1_ps( 0.25f );
+    __m512 x0 = _mm512_setzero_ps();
+    __m512 x1 = _mm512_setzero_ps();
+    __m512 x2 = _mm512_setzero_ps();
+    __m512 x3 = _mm512_setzero_ps();
+    __m512 x4 = _mm512_setzero_ps();
+    __m512 x5 = _mm512_setzero_ps();
+    __m512 x6 = _mm512_setzero_ps();
+    __m512 x7 = _mm512_setzero_ps();
+    __m512 x8 = _mm512_setzero_ps();
+    __m512 x9 = _mm512_setzero_ps();
+    __m512 x10 = _mm512_setzero_ps();
+    __m512 x11 = _mm512_setzero_ps();
+    for( uint32_t i = 0; i < nbIterations; ++i )
+    {
+        x0 = _mm512_fmadd_ps( x0, a, b );
+        x1 = _mm512_fmadd_ps( x1, a, b );
+        x2 = _mm512_fmadd_ps( x2, a, b );
+        x3 = _mm512_fmadd_ps( x3, a, b );
+        x4 = _mm512_fmadd_ps( x4, a, b );
+        x5 = _mm512_fmadd_ps( x5, a, b );
+        x6 = _mm512_fmadd_ps( x6, a, b );
+        x7 = _mm512_fmadd_ps( x7, a, b );
+        x8 = _mm512_fmadd_ps( x8, a, b );
+        x9 = _mm512_fmadd_ps( x9, a, b );
+        x10 = _mm512_fmadd_ps( x10, a, b );
+        x11 = _mm512_fmadd_ps( x11, a, b );
+    }
+
+    // Somme des chaines (le calcul ne peut pas etre elimine)
+    x0 = _mm512_add_ps( x0, x1 );
+    x2 = _mm512_add_ps( x2, x3 );
+    x4 = _mm512_add_ps( x4, x5 );
+    x6 = _mm512_add_ps( x6, x7 );
+    x8 = _mm512_add_ps( x8, x9 );
+    x10 = _mm512_add_ps( x10, x11 );
+    x0 = _mm512_add_ps( x0, x2 );
+    x4 = _mm512_add_ps( x4, x6 );
+    x8 = _mm512_add_ps( x8, x10 );
+    x0 = _mm512_add_ps( x0, x4 );
+    x0 = _mm512_add_ps( x0, x8 );
+    *result = _mm512_reduce_add_ps( x0 );
+
+    return( 2ull * 16 * PEAK_CHAINS * nbIterations );
+}
+
+#endif
+
+#ifdef KERNEL_X86
+
+// Noyaux entiers (8 bits)
+
+static int32_t dotInt8SSE2( const uint8_t* x, const int8_t* y, uint32_t n )
+{
+    // SSE2 n'a pas de multiplication 8 bits : les valeurs sont etendues sur 16 bits (x sans signe, y avec
+    // extension du signe), puis multipliees et sommees deux a deux sur 32 bits
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = _mm_setzero_si128();
+    uint32_t i = 0;
+    for( ; i + 16 <= n; i += 16 )
+    {
+        const __m128i vx = _mm_loadu_si128( (const __m128i*)( x + i ) );
+        const __m128i vy = _mm_loadu_si128( (const __m128i*)( y + i ) );
+        const __m128i xLow = _mm_unpacklo_epi8( vx, zero );
+        const __m128i xHigh = _mm_unpackhi_epi8( vx, zero );
+        const __m128i yLow = _mm_srai_epi16( _mm_unpacklo_epi8( vy, vy ), 8 );
+        const __m128i yHigh = _mm_srai_epi16( _mm_unpackhi_epi8( vy, vy ), 8 );
+        sum = _mm_add_epi32( sum, _mm_add_epi32( _mm_madd_epi16( xLow, yLow ), _mm_madd_epi16( xHigh, yHigh ) ) );
+    }
+
+    // Reduction, puis elements restants
+    sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    int32_t total = _mm_cvtsi128_si32( sum );
+    for( ; i < n; ++i ) total += (int32_t)x[i] * y[i];
+
+    return( total );
+}
+
+
+__attribute__(( target( "avx2" ) ))
+static int32_t dotInt8AVX2( const uint8_t* x, const int8_t* y, uint32_t n )
+{
+    // Produits 8 bits sommes deux a deux sur 16 bits (pas de saturation, x ne depassant pas 127), puis
+    // sommes quatre a quatre sur 32 bits
+    const __m256i ones = _mm256_set1_epi16( 1 );
+    __m256i sum0 = _mm256_setzero_si256();
+    __m256i sum1 = _mm256_setzero_si256();
+    uint32_t i = 0;
+    for( ; i + 64 <= n; i += 64 )
+    {
+        const __m256i p0 = _mm256_maddubs_epi16( _mm256_loadu_si256( (const __m256i*)( x + i ) ),
+                                                 _mm256_loadu_si256( (const __m256i*)( y + i ) ) );
+        const __m256i p1 = _mm256_maddubs_epi16( _mm256_loadu_si256( (const __m256i*)( x + i + 32 ) ),
+                                                 _mm256_loadu_si256( (const __m256i*)( y + i + 32 ) ) );
+        sum0 = _mm256_add_epi32( sum0, _mm256_madd_epi16( p0, ones ) );
+        sum1 = _mm256_add_epi32( sum1, _mm256_madd_epi16( p1, ones ) );
+    }
+    for( ; i + 32 <= n; i += 32 )
+    {
+        const __m256i p0 = _mm256_maddubs_epi16( _mm256_loadu_si256( (const __m256i*)( x + i ) ),
+                                                 _mm256_loadu_si256( (const __m256i*)( y + i ) ) );
+        sum0 = _mm256_add_epi32( sum0, _mm256_madd_epi16( p0, ones ) );
+    }
+    sum0 = _mm256_add_epi32( sum0, sum1 );
+
+    // Reduction, puis elements restants
+    __m128i half = _mm_add_epi32( _mm256_castsi256_si128( sum0 ), _mm256_extracti128_si256( sum0, 1 ) );
+    half = _mm_add_epi32( half, _mm_shuffle_epi32( half, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+    half = _mm_add_epi32( half, _mm_shuffle_epi32( half, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+    int32_t total = _mm_cvtsi128_si32( half );
+    for( ; i < n; ++i ) total += (int32_t)x[i] * y[i];
+
+    return( total );
+}
+
+#endif
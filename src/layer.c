@@ -6,76 +6,114 @@
 #include <string.h>
 #include <math.h>
 #include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
 
 // Local
 #include "ia/network.h"
+#include "ia/matrix.h"
+#include "ia/kernel.h"
+#include "ia/report.h"
+#include "ia/profile.h"
+
+// Proportion maximale d'entrees non nulles (1 / SPARSE_RATIO) pour le parcours creux de la premiere couche
+#define SPARSE_RATIO 3
+
+// Nombre minimal de poids d'une couche pour que leur initialisation soit repartie entre plusieurs threads
+#define PARALLEL_INIT_SIZE ( 1 << 20 )
 
 
 //--- Declaration des fonctions locales ------------------------------------------------------------------------
 
-/** Calcul de la valeur en denominateur de la fonction SOFTMAX
+/** Application de la fonction SOFTMAX (fonction d'activation des neurones de la couche de sortie)
  *
+ *  Les valeurs fournies sont les sommes ponderees (logits) des neurones de la couche, qui sont remplacees par
+ *  les sorties. Le maximum des logits est soustrait avant le calcul des exponentielles (log-sum-exp), de sorte
+ *  qu'aucune exponentielle ne depasse 1.0 (pas de debordement, quelle que soit l'amplitude des logits). Les
+ *  exponentielles sont approchees par le noyau vectorise KERNEL_exp() si fast est non nul
  */
-static double softmaxDenominator( Layer* layer, uint32_t nbInputs, const double* inputs );
+static void softmax( Real* values, uint32_t size, uint8_t fast );
 
-/** Initialisation des gradients d'erreur de la couche en fonction des sorties attendues (echantillon etiquete)
+/** Application de la fonction d'activation de la couche (SOFTMAX en sortie, sigmoide sur les couches internes)
  *
- *  Cette fonction n'est appelee que dans la couche de sortie, a la fin d'une propagation d'un echantillon
- *  qui possede des valeurs de sortie attendues. Elle initialise la retro-propagation des gradients de l'erreur
- *  pour la couche de sortie
+ *  Les sommes ponderees specifiees sont remplacees par les sorties. Les fonctions sont calculees par la libm, ou
+ *  par les noyaux vectorises approches si le reseau est configure ainsi (voir KERNEL_exp())
  */
-static void initError( Layer* layer, const Sample* sample );
+static void activate( const Layer* layer, Real* values );
 
+/** Couche d'entree dont les sorties non nulles peuvent remplacer les entrees specifiees de la couche
+ *
+ *  Retourne la couche precedente si elle est la couche d'entree, si les entrees sont ses sorties, et si la
+ *  proportion de sorties non nulles ne depasse pas 1 / SPARSE_RATIO (nul sinon : parcours de toutes les entrees)
+ */
+static inline const Layer* sparseInput( const Layer* layer, const Real* inputs );
 
-//--- Fonctions publiques --------------------------------------------------------------------------------------
+/** Mise a jour des poids d'un neurone (ligne row de la matrice des poids) selon l'optimiseur du reseau
+ *
+ *  Le gradient des poids est scale.inputs. Les poids et l'etat de l'optimiseur de la ligne (vitesses, ou
+ *  moyennes d'Adam) sont mis a jour en un seul parcours (voir KERNEL_momentum() et KERNEL_adam())
+ */
+static void updateRow( const Layer* layer, uint32_t row, double scale, const Real* inputs, double stepRate );
 
-Layer* LAYER_create( struct Network* network, uint32_t size, Layer* previous )
+/** Nombre de poids par neurone effectivement mis a jour pour les entrees specifiees (instrumentation)
+ *
+ */
+static inline uint32_t updateTerms( const Layer* layer, const Real* inputs );
+
+/** Nombre d'operations flottantes par poids d'une mise a jour selon l'optimiseur (instrumentation)
+ *
+ */
+static inline uint32_t updateFlops( const Layer* layer );
+
+/** Nombre de tableaux d'etat de l'optimiseur, lus et ecrits avec les poids (instrumentation)
+ *
+ */
+static inline uint32_t updateStates( const Layer* layer );
+
+/** Creation d'une couche, avec des poids initialises aleatoirement ou fournis (si specifies)
+ *
+ */
+static Layer* create( struct Network* network, uint32_t size, Layer* previous, Real* weights, Real* bias );
+
+/** Tranche de neurones d'une couche dont un thread initialise les poids
+ *
+ */
+typedef struct
 {
-    // Allocation de la struture de donnees
-    Layer* layer= (Layer*)malloc( sizeof( Layer ) );
-    memset( layer, 0, sizeof( Layer ) );
+    Layer* layer;                   // Couche initialisee
+    uint32_t begin;                 // Premier neurone de la tranche
+    uint32_t end;                   // Neurone suivant le dernier de la tranche
+} InitSlice;
 
-    // Nombre d'entrees des neurones de la couche (calcule ci-dessous)
-    uint32_t nbInputs = 0;
+/** Initialisation des poids de tous les neurones de la couche, repartie entre plusieurs threads si la couche
+ *  est grande
+ *
+ *  Les poids de chaque neurone sont tires de leur propre flux pseudo-aleatoire (numero de la couche et rang
+ *  du neurone), de sorte que les poids obtenus pour une graine ne dependent pas du nombre de threads
+ */
+static void initWeights( Layer* layer );
 
-    // S'il y a une couche precedente
-    if( previous )
-    {
-        // Interconnexion avec la couche precedente
-        layer->previous = previous;
-        previous->next = layer;
+/** Thread d'initialisation des poids d'une tranche de neurones
+ *
+ */
+static void* runInit( void* arg );
 
-        // Les neurones de la couche ont comme nombre d'entrees la dimension de la couche precedente
-        nbInputs = previous->nbNeurons;
-    }
-    else
-    {
-        // Sinon, on est sur la couche d'entree, les neurones ont une entree unique
-        layer->previous = NULL;
-        nbInputs = 1;
-    }
 
-	// Creation des neurones de la couche
-	layer->nbNeurons = size;
-    layer->neurons = (Neuron**)malloc( size * sizeof( Neuron*) );
-    for( uint32_t i = 0; i < size; ++i )
-    {
-        layer->neurons[i] = NEURON_create( network, nbInputs, i );
-    }
+//--- Fonctions publiques --------------------------------------------------------------------------------------
 
-    // Creation des valeurs de sortie de la couche
-    layer->output = (double*)malloc( layer->nbNeurons * sizeof( double ) );
-    memset( layer->output, 0, layer->nbNeurons * sizeof( double ) );
+Layer* LAYER_create( struct Network* network, uint32_t size, Layer* previous )
+{
+    return( create( network, size, previous, NULL, NULL ) );
+}
 
-    // Creation des gradients d'erreur de la couche
-    layer->error = (double*)malloc( layer->nbNeurons * sizeof( double ) );
-    memset( layer->error, 0, layer->nbNeurons * sizeof( double ) );
 
-    return( layer );
+Layer* LAYER_createMapped( struct Network* network, uint32_t size, Layer* previous, Real* weights, Real* bias )
+{
+    return( create( network, size, previous, weights, bias ) );
 }
 
 
-void LAYER_applySample( Layer* layer, Sample* sample )
+void LAYER_setInput( Layer* layer, const Sample* sample )
 {
     // Couche d'entree uniquement
     assert( layer->previous == NULL && "Envoi d'un echantillon sur un couche interne ou de sortie !" );
@@ -83,105 +121,266 @@ void LAYER_applySample( Layer* layer, Sample* sample )
     // Les donnees en entree doivent avoir la meme dimension que la couche
     assert( sample->inputSize == layer->nbNeurons );
 
-//printf( "--- Layer %u ---------------------------------------------------------\n", layer->nbNeurons );
-    // Pour chaque neurone de la couche
-    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+    // Les sorties de la couche d'entree sont les valeurs de l'echantillon (aucune copie), ainsi que la liste des
+    // sorties non nulles, pour le parcours creux de la couche suivante
+    layer->output = sample->input;
+    layer->nbNonZero = sample->nbNonZero;
+    layer->nonZero = sample->nonZeroIndexes;
+    layer->nonZeroValues = sample->nonZeroValues;
+}
+
+
+void LAYER_forward( Layer* layer, uint32_t nbInputs, const Real* inputs )
+{
+    // Les dimensions doivent etre identiques
+    assert( nbInputs == layer->nbInputs && "Nombre de valeurs incoherent en entree d'une couche !" );
+    PROFILE_START( start );
+
+    // Entrees creuses (sorties de la couche d'entree) : seules les entrees non nulles sont parcourues
+    const Layer* sparse = sparseInput( layer, inputs );
+    const uint32_t nbTerms = ( sparse != NULL ? sparse->nbNonZero : nbInputs );
+
+    // Pour chaque neurone de la couche (soit chaque ligne de la matrice des poids, parcourue dans l'ordre)...
+    const Real* weights = layer->weights;
+    for( uint32_t i = 0; i < layer->nbNeurons; ++i, weights += nbInputs )
     {
-        // Transmission de la valeur d'entree (unique) au neurone, et stockage de la valeur de sortie resultante
-        const double input = sample->input[i];
-        layer->output[i] = NEURON_forward( layer->neurons[i], 1, &input, 0.0 );
+        // Calcul (une seule fois) de la somme ponderee des valeurs fournies au neurone
+        layer->output[i] = ( sparse != NULL ?
+                             NEURON_weightedSumSparse( weights, layer->bias[i], nbTerms, sparse->nonZero,
+                                                       sparse->nonZeroValues ) :
+                             NEURON_weightedSum( weights, layer->bias[i], nbTerms, inputs ) );
     }
-//printf( "\n--- FIN Layer %u ---------------------------------------------------------\n", layer->nbNeurons );
 
-    // Propagation des valeurs de sortie (calculees ci-dessus) à la couche suivante
-    assert( layer->next && "Configuration de reseau incorrecte (une seule couche) !" );
-    LAYER_forward( layer->next, layer->nbNeurons, layer->output, sample );
+    // Application de la fonction d'activation aux sommes ponderees
+    activate( layer, layer->output );
+    PROFILE_STOP( start, layer, PROFILE_FORWARD, 2ull * nbTerms * layer->nbNeurons,
+                  ( (uint64_t)nbTerms * layer->nbNeurons + nbTerms + 2ull * layer->nbNeurons ) * sizeof( Real ) );
 }
 
 
-void LAYER_forward( Layer* layer, uint32_t nbInputs, const double* inputs, Sample* sample )
+void LAYER_initError( Layer* layer, const Sample* sample )
 {
-    // Si on est sur la couche de sortie, on utilise SOFTMAX comme fonction d'activation
-    double denominator = 0.0;
-    if( layer->next == NULL )
+    // Les dimensions des sorties obtenues et attendues doivent etre identiques
+    assert( layer->nbNeurons == sample->outputSize &&
+            "Nombre de valeurs incoherent en sortie d'un echantillon !" );
+
+    // Pour chaque neurone
+    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+    {
+        // Calcul de l'erreur en sortie (difference entre la valeur obtenue et attendue)
+        const double outputError = layer->output[i] - sample->output[i];
+        if( sample->digit == i && layer->network->verbosity >= REPORT_DEBUG )
+        {
+            fprintf( stdout, "  INFO - Erreur sur sortie %u = %.6f\n", i, outputError );
+        }
+
+        // Initialisation de l'erreur du neurone en fonction de l'erreur en sortie
+        layer->error[i] = NEURON_initError( layer->output[i], outputError );
+    }
+}
+
+
+void LAYER_backward( Layer* layer )
+{
+    // Couches internes uniquement (la couche d'entree n'a pas d'erreur, celle de sortie l'initialise)
+    assert( layer->previous != NULL && layer->next != NULL && "Retro-propagation hors d'une couche interne !" );
+
+    // Somme des erreurs de la couche suivante ponderees par les poids des liens entre chaque neurone et
+    // chacun des neurones de la couche suivante. La matrice des poids de la couche suivante est parcourue
+    // ligne par ligne (dans l'ordre de la memoire), chaque ligne contribuant a l'ensemble des sommes
+    PROFILE_START( start );
+    const Layer* next = layer->next;
+    memset( layer->error, 0, layer->nbNeurons * sizeof( Real ) );
+    const Real* weights = next->weights;
+    for( uint32_t j = 0; j < next->nbNeurons; ++j, weights += next->nbInputs )
     {
-        // Calcul du denominateur de la fonction SOFTMAX
-        denominator = softmaxDenominator( layer, nbInputs, inputs );
+        KERNEL_axpy( layer->error, next->error[j], weights, layer->nbNeurons );
     }
 
-//printf( "--- Layer %u ---------------------------------------------------------\n", layer->nbNeurons );
-    // Pour chaque neurone de la couche...
+    // Pour chaque neurone
+    const double lambda = layer->network->lambda;
     for( uint32_t i = 0; i < layer->nbNeurons; ++i )
     {
-        // Propagation des valeurs fournies au neurone, et stockage de la valeur de sortie resultante
-        layer->output[i] = NEURON_forward( layer->neurons[i], nbInputs, inputs, denominator );
+        // Calcul du gradient d'erreur du neurone en fonction des erreurs remontees par la couche suivante
+        layer->error[i] = NEURON_backward( layer->output[i], lambda, layer->error[i] );
     }
-//printf( "\n--- FIN Layer %u ---------------------------------------------------------\n", layer->nbNeurons );
+    PROFILE_STOP( start, next, PROFILE_BACKWARD, 2ull * next->nbInputs * next->nbNeurons,
+                  ( (uint64_t)next->nbInputs * next->nbNeurons + next->nbNeurons + 2ull * layer->nbNeurons ) *
+                  sizeof( Real ) );
+}
 
-    // Si couche suivante
-    if( layer->next )
+
+void LAYER_updateWeights( Layer* layer, double stepRate )
+{
+    // Pour chaque neurone de la couche (soit chaque ligne de la matrice des poids, parcourue dans l'ordre)
+    PROFILE_START( start );
+    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
     {
-        // Propagation des valeurs de sortie (calculees ci-dessus) à la couche suivante
-        LAYER_forward( layer->next, layer->nbNeurons, layer->output, sample );
+        // Mise a jour des poids du neurone
+        updateRow( layer, i, layer->error[i], layer->previous->output, stepRate );
     }
-    else
+    PROFILE_STOP( start, layer, PROFILE_UPDATE,
+                  (uint64_t)updateFlops( layer ) * updateTerms( layer, layer->previous->output ) * layer->nbNeurons,
+                  ( 2ull * ( 1 + updateStates( layer ) ) * updateTerms( layer, layer->previous->output ) *
+                    layer->nbNeurons + layer->nbInputs + layer->nbNeurons ) * sizeof( Real ) );
+}
+
+
+void LAYER_backwardUpdate( Layer* layer, double stepRate )
+{
+    // Couches internes et de sortie uniquement (la couche d'entree n'a pas de poids)
+    assert( layer->previous != NULL && "Retro-propagation dans la couche d'entree !" );
+
+    // Si la couche precedente est une couche interne, chaque ligne de la matrice des poids contribue aux sommes
+    // des erreurs ponderees de cette couche (avec les poids avant mise a jour), puis est mise a jour dans la
+    // meme passe : la matrice n'est parcourue qu'une fois. La couche d'entree n'a pas d'erreur, seule la mise
+    // a jour est alors effectuee
+    PROFILE_START( start );
+    Layer* previous = layer->previous;
+    const uint8_t propagate = ( previous->previous != NULL );
+    Real* weights = layer->weights;
+    if( propagate )
     {
-        // On est sur la couche de sortie. Si l'echantillon a des valeurs de sortie
-        if( sample->output != NULL )
+        // Avec un optimiseur autre que la descente simple, la contribution de la ligne aux erreurs precede sa
+        // mise a jour (avec son etat), la ligne etant encore dans le cache
+        memset( previous->error, 0, previous->nbNeurons * sizeof( Real ) );
+        for( uint32_t j = 0; j < layer->nbNeurons; ++j, weights += layer->nbInputs )
         {
-            // On est en phase d'apprentissage. On calcule les gradients d'erreur en fonction
-            // des valeurs de sorties obtenues et celles attendues (disponibles dans l'echantillon)
-            initError( layer, sample );
-            
-            // On lance la retro-propagation vers la couche precedente
-            LAYER_backward( layer->previous );
+            if( layer->network->optimizer == OPTIMIZER_SGD )
+            {
+                KERNEL_axpyUpdate( previous->error, layer->error[j], weights, -stepRate * layer->error[j],
+                                   previous->output, layer->nbInputs );
+            }
+            else
+            {
+                KERNEL_axpy( previous->error, layer->error[j], weights, layer->nbInputs );
+                updateRow( layer, j, layer->error[j], previous->output, stepRate );
+            }
         }
-        else
+
+        // Calcul du gradient d'erreur de chaque neurone de la couche precedente
+        const double lambda = layer->network->lambda;
+        for( uint32_t i = 0; i < previous->nbNeurons; ++i )
         {
-            // On est en phase d'exploitation, on copie les valeurs de sorties obtenues dans l'echantillon
-            SAMPLE_setOutput( sample, layer->nbNeurons, layer->output );
+            previous->error[i] = NEURON_backward( previous->output[i], lambda, previous->error[i] );
         }
     }
+    else
+    {
+        for( uint32_t j = 0; j < layer->nbNeurons; ++j )
+        {
+            updateRow( layer, j, layer->error[j], previous->output, stepRate );
+        }
+    }
+    PROFILE_STOP( start, layer, PROFILE_BACKWARD_UPDATE,
+                  ( ( propagate ? 2ull * layer->nbInputs : 0ull ) +
+                    (uint64_t)updateFlops( layer ) * updateTerms( layer, previous->output ) ) * layer->nbNeurons,
+                  ( 2ull * ( 1 + updateStates( layer ) ) * updateTerms( layer, previous->output ) * layer->nbNeurons +
+                    ( propagate ? 3ull : 1ull ) * layer->nbInputs + layer->nbNeurons ) * sizeof( Real ) );
 }
 
 
-void LAYER_backward( Layer* layer )
+void LAYER_forwardBatch( const Layer* layer, uint32_t nbSamples, const Real* inputs, Real* outputs )
 {
-    // Si on est sur la couche d'entree, la retro-propagation est terminee
-    if( layer->previous == NULL )
+    // Calcul des sommes ponderees de tous les neurones pour tous les echantillons (produit de matrices)
+    PROFILE_START( start );
+    MATRIX_multiplyNT( inputs, nbSamples, layer->weights, layer->nbNeurons, layer->nbInputs, outputs );
+
+    // Pour chaque echantillon du lot
+    for( uint32_t s = 0; s < nbSamples; ++s )
     {
-        // On met alors a jour les poids dans toutes les couches du reseau (la couche d'entree n'a pas
-        // de poids, et ne fait que transmettre directement la valeur en entree)
-        LAYER_updateWeights( layer->next );
+        // Ajout des biais aux sommes ponderees
+        Real* output = outputs + (size_t)s * layer->nbNeurons;
+        for( uint32_t i = 0; i < layer->nbNeurons; ++i ) output[i] += layer->bias[i];
+
+        // Application de la fonction d'activation
+        activate( layer, output );
     }
+    PROFILE_STOP( start, layer, PROFILE_FORWARD, 2ull * nbSamples * layer->nbInputs * layer->nbNeurons,
+                  ( (uint64_t)layer->nbInputs * layer->nbNeurons + layer->nbNeurons +
+                    (uint64_t)nbSamples * ( layer->nbInputs + layer->nbNeurons ) ) * sizeof( Real ) );
+}
 
-    // Sinon, on continue la retro-propagation
-    else
+
+void LAYER_initErrorBatch( const Layer* layer, uint32_t nbSamples, Sample** samples,
+                           const Real* outputs, Real* errors )
+{
+    // Pour chaque echantillon du lot
+    for( uint32_t s = 0; s < nbSamples; ++s )
     {
-        // Pour chaque neurone
+        // Les dimensions des sorties obtenues et attendues doivent etre identiques
+        assert( layer->nbNeurons == samples[s]->outputSize &&
+                "Nombre de valeurs incoherent en sortie d'un echantillon !" );
+
+        // Initialisation de l'erreur de chaque neurone en fonction de l'erreur en sortie
+        const Real* output = outputs + (size_t)s * layer->nbNeurons;
+        Real* error = errors + (size_t)s * layer->nbNeurons;
         for( uint32_t i = 0; i < layer->nbNeurons; ++i )
         {
-            // Calcul du gradient d'erreur du neurone en fonction des erreurs remontees par la couche suivante
-            layer->error[i] = NEURON_backward( layer->neurons[i], layer->next );
+            error[i] = NEURON_initError( output[i], output[i] - samples[s]->output[i] );
         }
+    }
+}
+
 
-        // On transmet la retro-propagation a la couche precedente
-        LAYER_backward( layer->previous );
+void LAYER_backwardBatch( const Layer* layer, uint32_t nbSamples, const Real* outputs,
+                          const Real* nextErrors, Real* errors )
+{
+    // Somme des erreurs de la couche suivante ponderees par les poids, pour tous les echantillons du lot
+    PROFILE_START( start );
+    const Layer* next = layer->next;
+    MATRIX_multiplyNN( nextErrors, nbSamples, next->weights, next->nbInputs, next->nbNeurons, errors );
+
+    // Calcul du gradient d'erreur de chaque neurone pour chaque echantillon
+    const double lambda = layer->network->lambda;
+    const size_t count = (size_t)nbSamples * layer->nbNeurons;
+    for( size_t i = 0; i < count; ++i )
+    {
+        errors[i] = NEURON_backward( outputs[i], lambda, errors[i] );
     }
+    PROFILE_STOP( start, next, PROFILE_BACKWARD, 2ull * nbSamples * next->nbInputs * next->nbNeurons,
+                  ( (uint64_t)next->nbInputs * next->nbNeurons +
+                    (uint64_t)nbSamples * ( next->nbNeurons + 2ull * layer->nbNeurons ) ) * sizeof( Real ) );
 }
 
 
-void LAYER_updateWeights( Layer* layer )
+void LAYER_accumulateGradients( const Layer* layer, uint32_t nbSamples, const Real* errors,
+                                const Real* inputs, Real* gradients )
 {
-    // Pour chaque neurone de la couche
-    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+    // Somme sur le lot des produits de l'erreur de chaque neurone par les entrees de la couche
+    PROFILE_START( start );
+    MATRIX_accumulateTN( errors, layer->nbNeurons, inputs, layer->nbInputs, nbSamples, gradients );
+    PROFILE_STOP( start, layer, PROFILE_GRADIENTS, 2ull * nbSamples * layer->nbInputs * layer->nbNeurons,
+                  ( 2ull * layer->nbInputs * layer->nbNeurons +
+                    (uint64_t)nbSamples * ( layer->nbInputs + layer->nbNeurons ) ) * sizeof( Real ) );
+}
+
+
+void LAYER_applyGradients( Layer* layer, uint32_t nbSamples, Real* gradients, double stepRate )
+{
+    // Mise a jour des poids de tous les neurones de la couche
+    LAYER_applyGradientRows( layer, nbSamples, gradients, stepRate, 0, layer->nbNeurons );
+}
+
+
+void LAYER_applyGradientRows( Layer* layer, uint32_t nbSamples, Real* gradients, double stepRate,
+                              uint32_t first, uint32_t count )
+{
+    // Les gradients etant sommes sur le lot, on les moyenne
+    PROFILE_START( start );
+    const double scale = 1.0 / nbSamples;
+
+    // Mise a jour des poids de chaque neurone (une seule ecriture des poids par lot)
+    Real* rows = gradients + (size_t)first * layer->nbInputs;
+    for( uint32_t i = 0; i < count; ++i )
     {
-        // Mise a jour des poids du neurone
-        NEURON_updateWeights( layer->neurons[i], layer->error[i], layer->previous );
+        updateRow( layer, first + i, scale, rows + (size_t)i * layer->nbInputs, stepRate );
     }
 
-    // Si il y a une couche suivante, on propage la mise a jour. Sinon, la mise a jour est terminee
-    if( layer->next != NULL ) LAYER_updateWeights( layer->next );
+    // Remise a zero des gradients pour le lot suivant
+    memset( rows, 0, (size_t)count * layer->nbInputs * sizeof( Real ) );
+    PROFILE_STOP( start, layer, PROFILE_UPDATE, (uint64_t)updateFlops( layer ) * count * layer->nbInputs,
+                  ( 4ull + 2ull * updateStates( layer ) ) * count * layer->nbInputs * sizeof( Real ) );
 }
 
 
@@ -190,51 +389,257 @@ void LAYER_destroy( Layer* layer )
     // Si valide
     if( layer != NULL )
     {
-        // Liberation des neurones
-        for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+        // Liberation memoire (les poids projetes en memoire sont liberes avec la projection)
+        if( !layer->mapped )
         {
-            if( layer->neurons[i] ) NEURON_destroy( layer->neurons[i] );
+            MATRIX_destroy( layer->weights );
+            MATRIX_destroy( layer->bias );
         }
-
-        // Liberation memoire
-        if( layer->neurons ) free( layer->neurons );
-        if( layer->output ) free( layer->output );
-        if( layer->error ) free( layer->error );
+        if( layer->previous != NULL ) MATRIX_destroy( layer->output );
+        MATRIX_destroy( layer->error );
+        MATRIX_destroy( layer->velocity );
+        MATRIX_destroy( layer->variance );
         free( layer );
     }
 }
 
 //--- Fonctions locales ----------------------------------------------------------------------------------------
 
-static double softmaxDenominator( Layer* layer, uint32_t nbInputs, const double* inputs )
+static Layer* create( struct Network* network, uint32_t size, Layer* previous, Real* weights, Real* bias )
 {
-    // Calcul de la somme des exponentielles des entrees ponderees par les poids de chaque neurone
-    double denominator = 0.0;
-    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+    // Allocation de la struture de donnees
+    Layer* layer= (Layer*)malloc( sizeof( Layer ) );
+    memset( layer, 0, sizeof( Layer ) );
+    layer->network = network;
+    layer->nbNeurons = size;
+
+    // S'il y a une couche precedente
+    if( previous )
     {
-        denominator += exp( NEURON_weightedSum( layer->neurons[i], nbInputs, inputs ) );
+        // Interconnexion avec la couche precedente
+        layer->previous = previous;
+        previous->next = layer;
+        layer->index = previous->index + 1;
+
+        // Les neurones de la couche ont comme nombre d'entrees la dimension de la couche precedente
+        layer->nbInputs = previous->nbNeurons;
+
+        // Poids et biais fournis (projetes en memoire) : utilises tels quels
+        if( weights != NULL )
+        {
+            layer->weights = weights;
+            layer->bias = bias;
+            layer->mapped = 1;
+        }
+        else
+        {
+            // Creation de la matrice des poids (une ligne par neurone) et des biais de la couche
+            layer->weights = MATRIX_create( layer->nbNeurons, layer->nbInputs );
+            layer->bias = MATRIX_create( 1, layer->nbNeurons );
+
+            // Initialisation des poids de chaque neurone selon la methode Xavier/Glorot
+            // TODO : methode d'initialisation du biais ?
+            initWeights( layer );
+
+            // Etat de l'optimiseur (nul au depart), a cote des poids : une vitesse, ou deux moyennes, par poids
+            const uint8_t optimizer = network->optimizer;
+            if( optimizer != OPTIMIZER_SGD ) layer->velocity = MATRIX_create( layer->nbNeurons, layer->nbInputs );
+            if( optimizer == OPTIMIZER_ADAM ) layer->variance = MATRIX_create( layer->nbNeurons, layer->nbInputs );
+        }
+
+        // Creation des valeurs de sortie de la couche
+        layer->output = MATRIX_create( 1, layer->nbNeurons );
+
+        // Creation des gradients d'erreur de la couche
+        layer->error = MATRIX_create( 1, layer->nbNeurons );
+    }
+    else
+    {
+        // Sinon, on est sur la couche d'entree, qui ne fait que presenter les entrees de l'echantillon (pas de
+        // poids, ni d'erreur, et des sorties fournies par LAYER_setInput())
+        layer->previous = NULL;
+        layer->nbInputs = 0;
     }
 
-    return( denominator );
+    return( layer );
 }
 
-static void initError( Layer* layer, const Sample* sample )
-{
-    // Les dimensions des sorties obtenues et attendues doivent etre identiques
-    assert( layer->nbNeurons == sample->outputSize &&
-            "Nombre de valeurs incoherent en sortie d'un echantillon !" );
 
-    // Pour chaque neurone
-    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+static void updateRow( const Layer* layer, uint32_t row, double scale, const Real* inputs, double stepRate )
+{
+    const struct Network* network = layer->network;
+    const size_t offset = (size_t)row * layer->nbInputs;
+    Real* weights = layer->weights + offset;
+    switch( network->optimizer )
     {
-        // Calcul de l'erreur en sortie (difference entre la valeur obtenue et attendue)
-        const double outputError = layer->output[i] - sample->output[i];
-        if( sample->digit == i )
+        case OPTIMIZER_MOMENTUM:
+            // v = mu.v + g, puis w = w - taux.v
+            KERNEL_momentum( weights, layer->velocity + offset, network->momentum, scale, 0.0, -stepRate,
+                             inputs, layer->nbInputs );
+            break;
+        case OPTIMIZER_NESTEROV:
+            // v = mu.v + g, puis w = w - taux.( g + mu.v ) (gradient evalue en avance sur la vitesse)
+            KERNEL_momentum( weights, layer->velocity + offset, network->momentum, scale, -stepRate * scale,
+                             -stepRate * network->momentum, inputs, layer->nbInputs );
+            break;
+        case OPTIMIZER_ADAM:
+            KERNEL_adam( weights, layer->velocity + offset, layer->variance + offset, network->momentum,
+                         network->beta2, scale, stepRate, network->epsilon, inputs, layer->nbInputs );
+            break;
+        default:
         {
-            fprintf( stdout, "  INFO - Erreur sur sortie %u = %.6f\n", i, outputError );
+            // Entrees creuses : seuls les poids des entrees non nulles changent (les optimiseurs avec etat
+            // parcourent toujours toute la ligne, l'etat de chaque poids evoluant meme sans gradient)
+            const Layer* sparse = sparseInput( layer, inputs );
+            if( sparse != NULL )
+            {
+                NEURON_updateWeightsSparse( weights, sparse->nbNonZero, stepRate * scale, sparse->nonZero,
+                                            sparse->nonZeroValues );
+            }
+            else
+            {
+                NEURON_updateWeights( weights, layer->nbInputs, stepRate * scale, inputs );
+            }
+            break;
         }
+    }
+}
 
-        // Initialisation de l'erreur du neurone en fonction de l'erreur en sortie
-        layer->error[i] = NEURON_initError( layer->neurons[i], outputError );
+
+static inline const Layer* sparseInput( const Layer* layer, const Real* inputs )
+{
+    const Layer* previous = layer->previous;
+    if( previous->previous != NULL || inputs != previous->output || previous->nonZero == NULL ) return( NULL );
+
+    return( (uint64_t)previous->nbNonZero * SPARSE_RATIO <= layer->nbInputs ? previous : NULL );
+}
+
+
+static inline uint32_t updateTerms( const Layer* layer, const Real* inputs )
+{
+    // Descente simple sur des entrees creuses : seuls les poids des entrees non nulles sont mis a jour
+    const Layer* sparse = sparseInput( layer, inputs );
+    return( sparse != NULL && layer->network->optimizer == OPTIMIZER_SGD ? sparse->nbNonZero : layer->nbInputs );
+}
+
+
+static inline uint32_t updateFlops( const Layer* layer )
+{
+    switch( layer->network->optimizer )
+    {
+        case OPTIMIZER_MOMENTUM:
+        case OPTIMIZER_NESTEROV:
+            return( 7 );
+        case OPTIMIZER_ADAM:
+            return( 13 );
+        default:
+            return( 2 );
+    }
+}
+
+
+static inline uint32_t updateStates( const Layer* layer )
+{
+    // Une vitesse par poids pour le moment, deux moyennes pour Adam
+    const uint8_t optimizer = layer->network->optimizer;
+    return( optimizer == OPTIMIZER_ADAM ? 2 : ( optimizer != OPTIMIZER_SGD ? 1 : 0 ) );
+}
+
+
+static void activate( const Layer* layer, Real* values )
+{
+    // SOFTMAX sur la couche de sortie
+    const uint8_t fast = layer->network->fastActivation;
+    if( layer->next == NULL )
+    {
+        softmax( values, layer->nbNeurons, fast );
+    }
+    // Sigmoide sur les couches internes, vectorisee ou neurone par neurone
+    else if( fast )
+    {
+        KERNEL_sigmoid( values, layer->network->lambda, layer->nbNeurons );
     }
+    else
+    {
+        const double lambda = layer->network->lambda;
+        for( uint32_t i = 0; i < layer->nbNeurons; ++i ) values[i] = NEURON_forward( values[i], lambda );
+    }
+}
+
+
+static void softmax( Real* values, uint32_t size, uint8_t fast )
+{
+    // Recherche du plus grand logit
+    double maxValue = values[0];
+    for( uint32_t i = 1; i < size; ++i )
+    {
+        if( values[i] > maxValue ) maxValue = values[i];
+    }
+
+    // SOFTMAX( Xi ) = exp( Xi - max ) / SOMME( exp( Xj - max ) ), les exponentielles etant calculees
+    // une seule fois et stockees en place avant la normalisation
+    double denominator = 0.0;
+    if( fast ) KERNEL_exp( values, 1.0, -maxValue, size );
+    for( uint32_t i = 0; i < size; ++i )
+    {
+        if( !fast ) values[i] = exp( values[i] - maxValue );
+        denominator += values[i];
+    }
+    const double inverse = 1.0 / denominator;
+    for( uint32_t i = 0; i < size; ++i ) values[i] *= inverse;
+}
+
+
+static void initWeights( Layer* layer )
+{
+    // Nombre de threads : un seul pour une petite couche (le cout de creation des threads dominerait)
+    const size_t nbWeights = (size_t)layer->nbNeurons * layer->nbInputs;
+    uint32_t nbThreads = 1;
+    if( nbWeights >= PARALLEL_INIT_SIZE ) nbThreads = (uint32_t)sysconf( _SC_NPROCESSORS_ONLN );
+    if( nbThreads > layer->nbNeurons ) nbThreads = layer->nbNeurons;
+    if( nbThreads <= 1 )
+    {
+        InitSlice slice = { layer, 0, layer->nbNeurons };
+        runInit( &slice );
+        return;
+    }
+
+    // Une tranche contigue de neurones par thread
+    pthread_t* threads = (pthread_t*)malloc( nbThreads * sizeof( pthread_t ) );
+    InitSlice* slices = (InitSlice*)malloc( nbThreads * sizeof( InitSlice ) );
+    for( uint32_t t = 0; t < nbThreads; ++t )
+    {
+        slices[t].layer = layer;
+        slices[t].begin = (uint32_t)( (uint64_t)layer->nbNeurons * t / nbThreads );
+        slices[t].end = (uint32_t)( (uint64_t)layer->nbNeurons * ( t + 1 ) / nbThreads );
+    }
+
+    // Les tranches des threads qui n'ont pas pu etre lances sont initialisees par le thread appelant
+    uint32_t nbStarted = 0;
+    while( nbStarted < nbThreads && pthread_create( &threads[nbStarted], NULL, runInit, &slices[nbStarted] ) == 0 )
+    {
+        nbStarted++;
+    }
+    for( uint32_t t = nbStarted; t < nbThreads; ++t ) runInit( &slices[t] );
+    for( uint32_t t = 0; t < nbStarted; ++t ) pthread_join( threads[t], NULL );
+
+    // Liberation memoire
+    free( slices );
+    free( threads );
+}
+
+
+static void* runInit( void* arg )
+{
+    const InitSlice* slice = (const InitSlice*)arg;
+    Layer* layer = slice->layer;
+    for( uint32_t i = slice->begin; i < slice->end; ++i )
+    {
+        // Flux propre au neurone : numero de la couche (poids forts), et rang du neurone dans la couche
+        Random random;
+        RANDOM_seed( &random, layer->network->seed, ( (uint64_t)layer->index << 32 ) | i );
+        NEURON_initWeights( layer->weights + (size_t)i * layer->nbInputs, layer->nbInputs, &random );
+    }
+
+    return( NULL );
 }
@@ -0,0 +1,206 @@
+#include "ia/loader.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+// Nombre d'iterations d'attente active avant de ceder le processeur
+#define SPIN_COUNT 64
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Thread producteur : chargement des echantillons dans la file
+ *
+ */
+static void* produce( void* arg );
+
+/** Attente breve (attente active, puis cession du processeur)
+ *
+ */
+static void pause( uint32_t* spins );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Loader* LOADER_create( const Dataset* dataset, const uint32_t* order, uint32_t nbSamples, uint8_t labelled,
+                       uint32_t depth, uint32_t nbHeld )
+{
+    // Allocation de la struture de donnees
+    Loader* loader = (Loader*)malloc( sizeof( Loader ) );
+    memset( loader, 0, sizeof( Loader ) );
+    loader->dataset = dataset;
+    loader->nbSamples = ( nbSamples < dataset->nbSamples ? nbSamples : dataset->nbSamples );
+    loader->order = order;
+    loader->labelled = labelled;
+
+    // Creation de la file
+    loader->capacity = ( depth > 0 ? depth : 1 );
+    loader->slots = (LoaderSlot*)calloc( loader->capacity, sizeof( LoaderSlot ) );
+    atomic_init( &loader->head, 0 );
+    atomic_init( &loader->tail, 0 );
+    atomic_init( &loader->done, 0 );
+    atomic_init( &loader->stop, 0 );
+    atomic_init( &loader->failed, 0 );
+    atomic_init( &loader->producerStalls, 0 );
+
+    // Echantillons preallouees : ceux de la file, plus ceux detenus par le consommateur
+    loader->nbBuffers = loader->capacity + ( nbHeld > 0 ? nbHeld : 1 );
+    loader->samples = SAMPLE_createPool( loader->nbBuffers, dataset->imageSize, SAMPLE_OUTPUT_SIZE );
+    atomic_init( &loader->released, 0 );
+
+    // Lancement du thread producteur
+    if( pthread_create( &loader->thread, NULL, produce, loader ) != 0 )
+    {
+        SAMPLE_destroyPool( loader->samples, loader->nbBuffers );
+        free( loader->slots );
+        free( loader );
+        return( NULL );
+    }
+
+    return( loader );
+}
+
+
+Sample* LOADER_next( Loader* loader, uint32_t* index )
+{
+    // Attente d'un element dans la file
+    const uint64_t head = atomic_load_explicit( &loader->head, memory_order_relaxed );
+    uint64_t tail = atomic_load_explicit( &loader->tail, memory_order_acquire );
+    if( tail == head )
+    {
+        uint32_t spins = 0;
+        loader->consumerStalls++;
+        while( tail == head )
+        {
+            // Fin des echantillons (le producteur depose tous ses elements avant de signaler la fin)
+            if( atomic_load_explicit( &loader->done, memory_order_acquire ) )
+            {
+                tail = atomic_load_explicit( &loader->tail, memory_order_acquire );
+                if( tail == head ) return( NULL );
+                break;
+            }
+            pause( &spins );
+            tail = atomic_load_explicit( &loader->tail, memory_order_acquire );
+        }
+    }
+
+    // Statistiques de remplissage de la file
+    loader->depthSum += tail - head;
+    loader->nbTaken++;
+
+    // Retrait de l'element
+    const LoaderSlot slot = loader->slots[head % loader->capacity];
+    atomic_store_explicit( &loader->head, head + 1, memory_order_release );
+    if( index != NULL ) *index = slot.index;
+
+    return( slot.sample );
+}
+
+
+void LOADER_release( Loader* loader, uint32_t count )
+{
+    const uint64_t released = atomic_load_explicit( &loader->released, memory_order_relaxed );
+    atomic_store_explicit( &loader->released, released + count, memory_order_release );
+}
+
+
+uint32_t LOADER_depth( const Loader* loader )
+{
+    const uint64_t tail = atomic_load_explicit( &loader->tail, memory_order_acquire );
+    const uint64_t head = atomic_load_explicit( &loader->head, memory_order_acquire );
+
+    return( (uint32_t)( tail - head ) );
+}
+
+
+int LOADER_failed( const Loader* loader )
+{
+    return( atomic_load_explicit( &loader->failed, memory_order_acquire ) );
+}
+
+
+void LOADER_destroy( Loader* loader )
+{
+    // Si valide
+    if( loader != NULL )
+    {
+        // Arret du thread producteur
+        atomic_store_explicit( &loader->stop, 1, memory_order_release );
+        pthread_join( loader->thread, NULL );
+
+        // Liberation memoire
+        SAMPLE_destroyPool( loader->samples, loader->nbBuffers );
+        free( loader->slots );
+        free( loader );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void* produce( void* arg )
+{
+    Loader* loader = (Loader*)arg;
+
+    // Pour chaque echantillon a charger
+    uint64_t tail = 0;
+    for( uint32_t i = 0; i < loader->nbSamples; ++i )
+    {
+        // Attente d'une place libre dans la file, et d'un echantillon rendu par le consommateur
+        uint64_t head = atomic_load_explicit( &loader->head, memory_order_acquire );
+        uint64_t released = atomic_load_explicit( &loader->released, memory_order_acquire );
+        if( tail - head == loader->capacity || tail - released == loader->nbBuffers )
+        {
+            uint32_t spins = 0;
+            atomic_fetch_add_explicit( &loader->producerStalls, 1, memory_order_relaxed );
+            while( tail - head == loader->capacity || tail - released == loader->nbBuffers )
+            {
+                if( atomic_load_explicit( &loader->stop, memory_order_acquire ) )
+                {
+                    atomic_store_explicit( &loader->done, 1, memory_order_release );
+                    return( NULL );
+                }
+                pause( &spins );
+                head = atomic_load_explicit( &loader->head, memory_order_acquire );
+                released = atomic_load_explicit( &loader->released, memory_order_acquire );
+            }
+        }
+
+        // Lecture, decodage et normalisation de l'image (une image illisible interrompt le chargement, comme
+        // le chargement a la demande)
+        const uint32_t index = ( loader->order != NULL ? loader->order[i] : i );
+        Sample* sample = loader->samples[tail % loader->nbBuffers];
+        if( DATASET_loadSample( loader->dataset, index, loader->labelled, sample ) != 0 )
+        {
+            atomic_store_explicit( &loader->failed, 1, memory_order_release );
+            break;
+        }
+
+        // Depot de l'echantillon
+        loader->slots[tail % loader->capacity].sample = sample;
+        loader->slots[tail % loader->capacity].index = index;
+        atomic_store_explicit( &loader->tail, ++tail, memory_order_release );
+    }
+
+    // Tous les echantillons ont ete deposes
+    atomic_store_explicit( &loader->done, 1, memory_order_release );
+
+    return( NULL );
+}
+
+
+static void pause( uint32_t* spins )
+{
+    if( ++( *spins ) < SPIN_COUNT )
+    {
+#if defined( __x86_64__ )
+        __builtin_ia32_pause();
+#endif
+    }
+    else
+    {
+        sched_yield();
+    }
+}
@@ -1,35 +1,96 @@
 // System
 #include <stdio.h>
 #include <stdlib.h>
-#include <dirent.h>
 #include <string.h>
+#include <time.h>
 
 // Local
 #include "ia/network.h"
 #include "ia/config.h"
 #include "ia/sample.h"
-
-// Repertoires des images d'entrainement et de test
+#include "ia/dataset.h"
+#include "ia/workspace.h"
+#include "ia/kernel.h"
+#include "ia/trainer.h"
+#include "ia/evaluator.h"
+#include "ia/report.h"
+#include "ia/profile.h"
+#include "ia/loader.h"
+#include "ia/quantized.h"
+#include "ia/checkpoint.h"
+#include "ia/validator.h"
+#include "ia/random.h"
+
+// Repertoires des images d'entrainement et de test (si non specifies dans la configuration)
 static const char* DIR_TRAINING = "data/images/training";
 static const char* DIR_TESTING = "data/images/testing";
 
+// Flux du generateur pseudo-aleatoire utilise pour le melange des images d'apprentissage (ceux de
+// l'initialisation des poids sont numerotes a partir de 2^32, voir module LAYER)
+static const uint64_t SHUFFLE_STREAM = 0;
+
 
 //--- Declaration fonctions locales ----------------------------------------------------------------------------
 
-/** Phase d'apprentissage
+/** Verification de la dimension des images d'un ensemble : elle doit etre celle de l'entree du reseau
+ *
+ *  Retourne 0 si les dimensions correspondent (un message d'erreur est affiche sinon)
+ */
+static int checkImageSize( const Dataset* dataset, const Network* network );
+
+/** Chargement en memoire des images d'un repertoire avec la methode de lecture specifiee, et bilan de la lecture
  *
+ *  En cas d'echec, les images restent lues a l'acces (les images illisibles sont alors ignorees)
  */
-static int learning( Network* network, const char* imageFolder );
+static void loadImages( Dataset* dataset, uint8_t backend );
+
+/** Phase d'apprentissage, sur le nombre d'epoques configure
+ *
+ *  Les images sont chargees en memoire avant la premiere epoque, sauf sur une seule epoque avec la lecture
+ *  sequentielle configuree (aucune lecture de fichier ensuite). Si demande, leur ordre est melange au debut de
+ *  chaque epoque. Si une validation est configuree, les dernieres images en sont exclues, et servent a valider
+ *  le reseau en parallele de l'apprentissage
+ */
+static int learningEpochs( Network* network, const Config* cfg, Dataset* dataset );
+
+/** Epoque d'apprentissage sur nbImages images, de rangs specifies (dans l'ordre de l'ensemble si order est nul)
+ *
+ *  La validation (si non nulle) est informee des echantillons appris, et peut interrompre l'epoque
+ */
+static int learning( Network* network, const Config* cfg, const Dataset* dataset, const uint32_t* order,
+                     uint32_t nbImages, uint32_t epoch, Validator* validator );
+
+/** Epoque d'apprentissage parallele (sur plusieurs threads)
+ *
+ *  La validation (si non nulle) n'est informee des echantillons appris qu'a la fin de l'epoque
+ */
+static int parallelLearning( Network* network, const Config* cfg, const Dataset* dataset, const uint32_t* order,
+                             uint32_t nbImages, uint32_t epoch, Validator* validator );
 
 /** Phase d'exploitation
  *
  */
-static void testing( Network* network, const char* imageFolder );
+static void testing( Network* network, const Config* cfg, const Dataset* dataset );
+
+/** Exploitation de la version quantifiee (8 bits) du reseau, comparee a celle du reseau d'origine
+ *
+ */
+static void testingQuantized( const Network* network, const Config* cfg, const Dataset* dataset, double precision );
+
+/** Exploitation seule d'un reseau charge a partir d'un point de sauvegarde (pas d'apprentissage)
+ *
+ */
+static int inference( const char* checkpoint, const char* images );
 
-/** Construit un nom de fichier image complet, et retourne l'etiquette (chiffre) associee
+/** Compactage d'un ensemble d'images (repertoire ou fichiers IDX) dans un fichier compact
  *
  */
-static int16_t buildPath( char* filePath, const char* dirName, const char* fileName );
+static int pack( const char* source, const char* fileName );
+
+/** Construit le nom d'une image pour l'affichage (nom de fichier, ou rang de l'image)
+ *
+ */
+static const char* buildName( char* buffer, const Dataset* dataset, uint32_t index );
 
 
 
@@ -37,171 +98,514 @@ static int16_t buildPath( char* filePath, const char* dirName, const char* fileN
 
 int main( int argc, char* argv[] )
 {
+    // Mode compactage d'un ensemble d'images
+    if( argc == 4 && strcmp( argv[1], "--pack" ) == 0 )
+    {
+        return( pack( argv[2], argv[3] ) );
+    }
+
+    // Mode exploitation seule d'un reseau sauvegarde
+    if( argc == 4 && strcmp( argv[1], "--infer" ) == 0 )
+    {
+        return( inference( argv[2], argv[3] ) );
+    }
+
     // Verification ligne de commande
     if( argc != 2 )
     {
         fprintf( stderr, "Ligne de commande incorrecte!\n" );
         fprintf( stderr, "Usage: reseau CONFIG\n" );
+        fprintf( stderr, "       reseau --pack IMAGES FICHIER\n" );
+        fprintf( stderr, "       reseau --infer SAUVEGARDE IMAGES\n" );
         return( 1 );
     }
-    
+
     // Lecture de la configuration
     Config* cfg = CONFIG_create();
     if( CONFIG_readFromFile( cfg, argv[1] ) != 0 ) return( 2 );
 
+    // Selection des noyaux de calcul adaptes au processeur
+    printf( "INFO - Noyaux de calcul : %s (%s)\n", KERNEL_init(), REAL_NAME );
+
     // Creation du reseau
     Network* network = NETWORK_create( cfg );
 
     // Phase d'apprentissage
     printf( "--- DEBUT PHASE D'APPRENTISSAGE --------------------------------------------------------\n" );
-    if( learning( network, DIR_TRAINING ) != 0 ) return( 3 );
+    Dataset* training = DATASET_open( cfg->trainingPath[0] != '\0' ? cfg->trainingPath : DIR_TRAINING );
+    if( training == NULL || checkImageSize( training, network ) != 0 ) return( 3 );
+    if( learningEpochs( network, cfg, training ) != 0 ) return( 3 );
+    DATASET_destroy( training );
     printf( "--- FIN PHASE D'APPRENTISSAGE   --------------------------------------------------------\n" );
 
+    // Sauvegarde du reseau entraine (si demande)
+    if( cfg->checkpointPath[0] != '\0' )
+    {
+        if( CHECKPOINT_save( network, cfg->checkpointPath ) != 0 ) return( 4 );
+        printf( "INFO - Reseau sauvegarde dans %s\n", cfg->checkpointPath );
+    }
+
     // Phase d'exploitation
     printf( "--- DEBUT PHASE DE TEST ----------------------------------------------------------------\n" );
-    testing( network, DIR_TESTING );
+    int status = 0;
+    Dataset* tests = DATASET_open( cfg->testingPath[0] != '\0' ? cfg->testingPath : DIR_TESTING );
+    if( tests != NULL )
+    {
+        if( checkImageSize( tests, network ) == 0 )
+        {
+            if( cfg->ingest != INGEST_NONE ) loadImages( tests, cfg->ingest );
+            testing( network, cfg, tests );
+        }
+        else
+        {
+            status = 5;
+        }
+        DATASET_destroy( tests );
+    }
     printf( "--- FIN PHASE DE TEST ------------------------------------------------------------------\n" );
 
+    // Profil des couches (si compile avec l'instrumentation)
+    PROFILE_report();
+
     // Liberation memoire
     NETWORK_destroy( network );
     CONFIG_destroy( cfg );
 
-    return( 0 );
+    return( status );
 }
 
 
 //--- Fonctions locales ----------------------------------------------------------------------------------------
 
-static int learning( Network* network, const char* imageFolder )
+static int checkImageSize( const Dataset* dataset, const Network* network )
 {
-    // Ouverture du repertoire qui contient les images pour la phase d'apprentissage
-    DIR* dir = opendir( imageFolder );
-    if( dir == NULL )
+    if( dataset->imageSize != network->input->nbNeurons )
     {
-        fprintf( stderr, "ERREUR - Impossible d'ouvror le répertoire %s\n", imageFolder );
+        fprintf( stderr, "ERREUR - Dimension des images (%u pixels) differente de l'entree du reseau (%u)\n",
+                 dataset->imageSize, network->input->nbNeurons );
         return( 1 );
     }
 
-    // Pour chaque entree du repertoire
-    uint32_t nbImages = 0;
-    struct dirent *entry = NULL;
-    // Compteur pour limiter l'entrainement
-    int cpt = 0;    
-    while( ( entry = readdir( dir ) ) != NULL && cpt <60000 )
+    return( 0 );
+}
+
+
+static void loadImages( Dataset* dataset, uint8_t backend )
+{
+    // Images deja en memoire (fichier compact ou IDX)
+    if( dataset->pixels != NULL ) return;
+
+    IngestStats stats;
+    if( DATASET_load( dataset, backend, &stats ) != 0 )
     {
-        // On ignore tout fichier qui ne commence pas par "image-"
-        const char* fileName = entry->d_name;
-        if( strncmp( fileName, "image-", 6 ) != 0 ) continue;
+        fprintf( stderr, "ATTENTION - %u images sur %u illisibles, lecture des images a l'acces\n", stats.nbFailed,
+                 stats.nbFiles );
+        return;
+    }
+    fprintf( stdout, "INFO - %u images chargees en memoire en %.3f s (%s : %.0f fichiers/s, %.1f Mo/s)\n",
+             dataset->nbSamples, stats.duration, INGEST_name( stats.backend ),
+             ( stats.duration > 0.0 ? stats.nbFiles / stats.duration : 0.0 ),
+             ( stats.duration > 0.0 ? stats.nbBytes / stats.duration * 1e-6 : 0.0 ) );
+}
+
 
-        // On construit le chemin complet, et on recupere le chiffre associe a l'image
-        char filePath[256];
-        const int16_t digit = buildPath( filePath, imageFolder, fileName );
-        if( digit < 0 || digit > 9 )
+static int learningEpochs( Network* network, const Config* cfg, Dataset* dataset )
+{
+    // Les images d'un repertoire sont lues par paquets et decodees une seule fois (sur plusieurs epoques, meme
+    // avec la lecture sequentielle)
+    if( cfg->nbEpochs > 1 || cfg->ingest != INGEST_NONE ) loadImages( dataset, cfg->ingest );
+
+    // Images mises de cote pour la validation (les dernieres de l'ensemble), exclues de l'apprentissage
+    uint32_t nbTraining = dataset->nbSamples;
+    Validator* validator = NULL;
+    if( cfg->nbValidation > 0 )
+    {
+        if( cfg->nbValidation >= dataset->nbSamples )
         {
-            fprintf( stderr, "ERREUR - Etiquette d'image incorrecte: %s\n", fileName );
-            continue;
+            fprintf( stderr, "ERREUR - Pas d'image d'apprentissage hors validation (%u images)\n", dataset->nbSamples );
+            return( 1 );
         }
+        nbTraining -= cfg->nbValidation;
+        validator = VALIDATOR_create( network, cfg, dataset, nbTraining, cfg->nbValidation );
+        if( validator == NULL ) return( 1 );
+        fprintf( stdout, "INFO - %u images mises de cote pour la validation\n", cfg->nbValidation );
+    }
+
+    // Ordre des images, melange en place au debut de chaque epoque (si demande)
+    uint32_t* order = NULL;
+    Random random;
+    if( cfg->shuffle )
+    {
+        RANDOM_seed( &random, cfg->seed, SHUFFLE_STREAM );
+        order = (uint32_t*)malloc( nbTraining * sizeof( uint32_t ) );
+        for( uint32_t i = 0; i < nbTraining; ++i ) order[i] = i;
+    }
+
+    // Pour chaque epoque (jusqu'a l'arret anticipe eventuel)
+    int status = 0;
+    for( uint32_t epoch = 1; epoch <= cfg->nbEpochs && status == 0; ++epoch )
+    {
+        if( validator != NULL && VALIDATOR_shouldStop( validator ) ) break;
+        if( cfg->nbEpochs > 1 ) fprintf( stdout, "> Epoque %u/%u\n", epoch, cfg->nbEpochs );
+        if( order != NULL ) DATASET_shuffle( order, nbTraining, &random );
+
+        // Le numero de l'epoque n'apparait dans les statistiques que s'il y en a plusieurs
+        const uint32_t reportEpoch = ( cfg->nbEpochs > 1 ? epoch : 0 );
+        if( cfg->nbThreads == 1 ) status = learning( network, cfg, dataset, order, nbTraining, reportEpoch, validator );
+        else status = parallelLearning( network, cfg, dataset, order, nbTraining, reportEpoch, validator );
 
-        // Creation d'un echantillon sur la base de l'image
-        fprintf( stdout, "> Apprentissage (step #%u) avec %s [chiffre = %d]...\n", ++nbImages, fileName, digit );
-        Sample* sample = SAMPLE_create( filePath, digit );
-        if( sample == NULL ) return( 1 );
-        NETWORK_applySample( network, sample );
-        fprintf( stdout, "< OK\n" );
-        cpt++;
+        // Sans intervalle de validation, les poids sont valides a la fin de chaque epoque
+        if( validator != NULL && cfg->validationInterval == 0 ) VALIDATOR_submit( validator, network );
     }
 
-    // Fermeture du repertoire
-    closedir( dir );
+    // Validation des derniers poids, et restauration de ceux de la meilleure validation (si demande)
+    if( validator != NULL )
+    {
+        VALIDATOR_finish( validator, network );
+        if( cfg->keepBest && status == 0 && VALIDATOR_restoreBest( validator, network ) == 0 )
+        {
+            fprintf( stdout, "INFO - Poids de la meilleure validation restaures\n" );
+        }
+    }
 
-    return( 0 );
+    // Liberation memoire
+    VALIDATOR_destroy( validator );
+    free( order );
+
+    return( status );
 }
 
-static void testing( Network* network, const char* imageFolder )
+
+static int learning( Network* network, const Config* cfg, const Dataset* dataset, const uint32_t* order,
+                     uint32_t nbImages, uint32_t epoch, Validator* validator )
 {
-    // Ouverture du repertoire qui contient les images pour la phase d'apprentissage
-    DIR* dir = opendir( imageFolder );
-    if( dir == NULL )
+    // Si demande, les images sont lues et decodees a l'avance par un thread de prechargement
+    const uint32_t batchSize = network->batchSize;
+    Loader* loader = NULL;
+    if( cfg->prefetch > 0 )
     {
-        fprintf( stderr, "ERREUR - Impossible d'ouvror le répertoire %s\n", imageFolder );
-        return;
+        loader = LOADER_create( dataset, order, nbImages, 1, cfg->prefetch, batchSize );
+        if( loader == NULL ) fprintf( stderr, "ATTENTION - Prechargement impossible, images chargees a la demande\n" );
     }
 
-    // Pour chaque entree du repertoire
-    uint32_t nbImages = 0;
-    uint32_t nb_ImagesValides = 0;
-    struct dirent *entry = NULL;
-    while( ( entry = readdir( dir ) ) != NULL )
+    // Les echantillons sont accumules dans un lot avant d'etre appliques ensemble (lot d'un seul echantillon
+    // en apprentissage echantillon par echantillon). Sans prechargement, les echantillons du lot sont
+    // alloues une fois pour toutes, et reutilises d'un lot a l'autre
+    Workspace* workspace = ( batchSize > 1 ? WORKSPACE_create( network, batchSize, 1 ) : NULL );
+    Sample** pool = NULL;
+    if( loader == NULL ) pool = SAMPLE_createPool( batchSize, network->input->nbNeurons, network->output->nbNeurons );
+    Sample** batch = (Sample**)malloc( batchSize * sizeof( Sample* ) );
+    uint32_t batchCount = 0;
+
+    // Suivi de la perte, de la precision et du debit (sorties du reseau pour chaque lot appris)
+    const Layer* output = network->output;
+    const Real* outputs = ( workspace != NULL ? workspace->outputs[output->index] : output->output );
+    Report* report = REPORT_create( cfg );
+    report->epoch = epoch;
+    REPORT_begin( report, "apprentissage", nbImages );
+
+    // Pour chaque image (dans l'ordre de l'epoque)
+    int status = 0;
+    for( uint32_t i = 0; i < nbImages; ++i )
     {
-        // On ignore tout fichier qui ne commence pas par "image-"
-        const char* fileName = entry->d_name;
-        if( strncmp( fileName, "image-", 6 ) != 0 ) continue;
-
-        // On construit le chemin complet, et on recupere le chiffre associe a l'image
-        char filePath[256];
-        const int16_t digit = buildPath( filePath, imageFolder, fileName );
-        if( digit < 0 || digit > 9 )
+        // Rang de l'image, et recuperation de l'echantillon precharge
+        uint32_t index = ( order != NULL ? order[i] : i );
+        Sample* sample = NULL;
+        if( loader != NULL )
         {
-            fprintf( stderr, "ERREUR - Etiquette d'image incorrecte: %s\n", fileName );
-            continue;
+            sample = LOADER_next( loader, &index );
+            if( sample == NULL )
+            {
+                if( LOADER_failed( loader ) ) status = 1;
+                break;
+            }
         }
-
-        // Creation d'un echantillon sur la base de l'image, mais sans les sorties attendues
-        fprintf( stdout, "> Phase de test (step #%u) avec %s [chiffre = %d]...\n", ++nbImages, fileName, digit );
-        Sample* sample = SAMPLE_create( filePath, -1 );
-        if( sample != NULL )
+        char name[32];
+        if( cfg->verbosity >= REPORT_SAMPLES )
         {
-            // Application de l'echantillon
-            NETWORK_applySample( network, sample );
+            fprintf( stdout, "> Apprentissage (step #%u) avec %s [chiffre = %d]...\n",
+                     i + 1, buildName( name, dataset, index ), dataset->labels[index] );
+        }
 
-            // Recherche de la probabilite la plus elevee
-            double maxProba = 0.0;
-            int16_t maxIndex = 0;
-            for( int16_t i = 0; i < sample->outputSize; ++i )
+        // Ou chargement de l'image dans l'echantillon suivant du lot
+        if( loader == NULL )
+        {
+            sample = pool[batchCount];
+            if( DATASET_loadSample( dataset, index, 1, sample ) != 0 )
             {
-                if( sample->output[i] > maxProba )
-                {
-                    maxProba = sample->output[i];
-                    maxIndex = i;
-                }
+                status = 1;
+                break;
             }
+        }
+
+        // Ajout de l'echantillon au lot, et apprentissage sur le lot lorsqu'il est complet
+        batch[batchCount++] = sample;
+        if( batchCount == batchSize )
+        {
+            if( workspace != NULL ) NETWORK_applyBatch( network, workspace, batch, batchCount );
+            else NETWORK_applySample( network, sample );
+            REPORT_addBatch( report, outputs, output->nbNeurons, batch, batchCount );
+            if( loader != NULL ) LOADER_release( loader, batchCount );
+            if( validator != NULL ) VALIDATOR_step( validator, network, batchCount );
+            batchCount = 0;
+        }
+        if( cfg->verbosity >= REPORT_SAMPLES ) fprintf( stdout, "< OK\n" );
+
+        // Arret anticipe demande par la validation
+        if( validator != NULL && VALIDATOR_shouldStop( validator ) ) break;
+    }
+
+    // Apprentissage sur le dernier lot (incomplet)
+    if( batchCount > 0 && status == 0 )
+    {
+        NETWORK_applyBatch( network, workspace, batch, batchCount );
+        REPORT_addBatch( report, outputs, output->nbNeurons, batch, batchCount );
+        if( loader != NULL ) LOADER_release( loader, batchCount );
+        if( validator != NULL ) VALIDATOR_step( validator, network, batchCount );
+    }
+    REPORT_end( report );
+
+    // Statistiques du prechargement
+    if( loader != NULL )
+    {
+        fprintf( stdout, "INFO - Prechargement (file de %u) : %llu attentes de l'apprentissage, "
+                 "%llu attentes du chargement, profondeur moyenne %.1f\n",
+                 loader->capacity, (unsigned long long)loader->consumerStalls,
+                 (unsigned long long)atomic_load( &loader->producerStalls ),
+                 loader->nbTaken > 0 ? (double)loader->depthSum / loader->nbTaken : 0.0 );
+        LOADER_destroy( loader );
+    }
+
+    // Liberation memoire
+    REPORT_destroy( report );
+    WORKSPACE_destroy( workspace );
+    SAMPLE_destroyPool( pool, batchSize );
+    free( batch );
+
+    return( status );
+}
+
 
-            // Si la probabilite max correspond au chiffre, le test est concluant (et faux sinon)
-            if( maxIndex == digit ){
-                fprintf( stdout, "< OK (chiffre identifié avec une probabilité de %f)\n", maxProba );
-                nb_ImagesValides++;
+static int parallelLearning( Network* network, const Config* cfg, const Dataset* dataset, const uint32_t* order,
+                             uint32_t nbImages, uint32_t epoch, Validator* validator )
+{
+    // Apprentissage sur tous les threads
+    Trainer* trainer = TRAINER_create( network, cfg );
+    fprintf( stdout, "> Apprentissage parallele (%u threads, mode %s, lots de %u) sur %u images...\n",
+             trainer->nbThreads, ( trainer->hogwild ? "hogwild" : "synchrone" ), trainer->batchSize, nbImages );
+    trainer->report = REPORT_create( cfg );
+    trainer->report->epoch = epoch;
+    REPORT_begin( trainer->report, "apprentissage", nbImages );
+    struct timespec start, end;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    const uint32_t nbLearned = TRAINER_run( trainer, dataset, order, nbImages );
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    REPORT_end( trainer->report );
+    const double duration = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+    fprintf( stdout, "< OK (%u echantillons en %.3f s, soit %.0f echantillons/s)\n",
+             nbLearned, duration, nbLearned / duration );
+
+    // Les poids ne sont stables qu'une fois tous les threads termines
+    if( validator != NULL ) VALIDATOR_step( validator, network, nbLearned );
+
+    // Comme en apprentissage sequentiel, l'epoque est en echec si des images n'ont pas pu etre apprises
+    int status = 0;
+    if( nbLearned < nbImages )
+    {
+        fprintf( stderr, "ERREUR - %u images sur %u n'ont pas pu etre apprises\n", nbImages - nbLearned, nbImages );
+        status = 1;
+    }
+
+    // Liberation memoire
+    REPORT_destroy( trainer->report );
+    TRAINER_destroy( trainer );
+
+    return( status );
+}
+
+static void testing( Network* network, const Config* cfg, const Dataset* dataset )
+{
+    // Classification des images en parallele sur tous les coeurs, comme en exploitation (le reseau est partage
+    // en lecture seule par les threads, le resultat ne depend pas de leur nombre ; la cle "threads:" ne porte
+    // que sur l'apprentissage)
+    const uint32_t nbImages = dataset->nbSamples;
+    int16_t* predicted = (int16_t*)malloc( ( nbImages + 1 ) * sizeof( int16_t ) );
+    double* probabilities = (double*)malloc( ( nbImages + 1 ) * sizeof( double ) );
+    Evaluator* evaluator = EVALUATOR_create( network, 0 );
+    evaluator->report = REPORT_create( cfg );
+    REPORT_begin( evaluator->report, "test", nbImages );
+    struct timespec start, end;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    EVALUATOR_run( evaluator, dataset, predicted, probabilities );
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    REPORT_end( evaluator->report );
+    const double duration = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+
+    // Pour chaque image (le detail n'est affiche qu'a la demande)
+    const uint8_t verbose = ( cfg->verbosity >= REPORT_SAMPLES );
+    uint32_t nb_ImagesValides = 0;
+    for( uint32_t i = 0; i < nbImages; ++i )
+    {
+        char name[32];
+        const int16_t digit = dataset->labels[i];
+        if( verbose )
+        {
+            fprintf( stdout, "> Phase de test (step #%u) avec %s [chiffre = %d]...\n",
+                     i + 1, buildName( name, dataset, i ), digit );
+        }
+        if( predicted[i] < 0 )
+        {
+            if( verbose ) fprintf( stdout, "< ERROR\n" );
+        }
+        else if( predicted[i] == digit )
+        {
+            // La probabilite max correspond au chiffre, le test est concluant
+            if( verbose )
+            {
+                fprintf( stdout, "< OK (chiffre identifié avec une probabilité de %f)\n", probabilities[i] );
             }
-                
-            else
-                fprintf( stdout, "< KO (chiffre identifié = %d, chiffre attendu = %d)\n", maxIndex, digit );
+            nb_ImagesValides++;
         }
         else
         {
-            fprintf( stdout, "< ERROR\n" );
+            if( verbose )
+            {
+                fprintf( stdout, "< KO (chiffre identifié = %d, chiffre attendu = %d)\n", predicted[i],
+                         digit );
+            }
         }
-
     }
     printf("INFO Precision = %lf\n",((double)nb_ImagesValides/(double)nbImages)*100);
+    printf( "INFO Classification de %u images en %.3f s (%u threads, soit %.0f images/s)\n",
+            nbImages, duration, evaluator->nbThreads, nbImages / duration );
+
+    // Liberation memoire
+    REPORT_destroy( evaluator->report );
+    EVALUATOR_destroy( evaluator );
+    free( predicted );
+    free( probabilities );
+
+    // Comparaison avec le reseau quantifie (si demande)
+    if( cfg->quantize )
+    {
+        testingQuantized( network, cfg, dataset, ( (double)nb_ImagesValides / (double)nbImages ) * 100 );
+    }
 }
 
 
-static int16_t buildPath( char* filePath, const char* dirName, const char* fileName )
+static void testingQuantized( const Network* network, const Config* cfg, const Dataset* dataset, double precision )
 {
-    // Constrution du chemin complet
-    sprintf( filePath, "%s/%s", dirName, fileName );
+    // Quantification du reseau
+    QuantizedNetwork* quantized = QUANTIZED_create( network );
+    size_t size = 0;
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        size += (size_t)layer->nbNeurons * ( layer->nbInputs + 1 ) * sizeof( Real );
+    }
+    printf( "INFO Reseau quantifie sur 8 bits : %zu octets de poids (contre %zu)\n",
+            QUANTIZED_size( quantized ), size );
+
+    // Classification des images avec le reseau quantifie (sur tous les coeurs, comme la phase de test)
+    const uint32_t nbImages = dataset->nbSamples;
+    int16_t* predicted = (int16_t*)malloc( ( nbImages + 1 ) * sizeof( int16_t ) );
+    double* probabilities = (double*)malloc( ( nbImages + 1 ) * sizeof( double ) );
+    Evaluator* evaluator = EVALUATOR_createQuantized( quantized, 0 );
+    evaluator->report = REPORT_create( cfg );
+    REPORT_begin( evaluator->report, "test_int8", nbImages );
+    struct timespec start, end;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    EVALUATOR_run( evaluator, dataset, predicted, probabilities );
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    REPORT_end( evaluator->report );
+    const double duration = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+
+    // Precision du reseau quantifie, et ecart avec celle du reseau d'origine
+    uint32_t nbValid = 0;
+    for( uint32_t i = 0; i < nbImages; ++i )
+    {
+        if( predicted[i] >= 0 && predicted[i] == dataset->labels[i] ) nbValid++;
+    }
+    const double quantizedPrecision = ( (double)nbValid / (double)nbImages ) * 100;
+    printf( "INFO Precision int8 = %lf (ecart %+.3lf points)\n", quantizedPrecision, quantizedPrecision - precision );
+    printf( "INFO Classification int8 de %u images en %.3f s (%u threads, soit %.0f images/s)\n",
+            nbImages, duration, evaluator->nbThreads, nbImages / duration );
 
-    // Extraction du chiffre associe a l'image du nom du fichier. Le fichier suit le format
-    // "image-<num>-label-<digit>.pgm". On veut extraire le segment entre le dernier '-' et le '.'
-    char* ptrDash = strrchr( fileName, '-' );
-    char* ptrDot = strchr( fileName, '.' );
-    if( ptrDot - ptrDash != 2 )
+    // Liberation memoire
+    REPORT_destroy( evaluator->report );
+    EVALUATOR_destroy( evaluator );
+    QUANTIZED_destroy( quantized );
+    free( predicted );
+    free( probabilities );
+}
+
+
+static int inference( const char* checkpoint, const char* images )
+{
+    // Selection des noyaux de calcul adaptes au processeur
+    printf( "INFO - Noyaux de calcul : %s (%s)\n", KERNEL_init(), REAL_NAME );
+
+    // Chargement du reseau (projection du point de sauvegarde en memoire)
+    struct timespec start, end;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    Network* network = CHECKPOINT_load( checkpoint );
+    if( network == NULL ) return( 2 );
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    const double duration = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+    printf( "INFO - Reseau charge a partir de %s en %.3f ms\n", checkpoint, duration * 1e3 );
+
+    // Phase d'exploitation, sur tous les coeurs disponibles
+    int status = 0;
+    Config* cfg = CONFIG_create();
+    cfg->nbThreads = 0;
+    printf( "--- DEBUT PHASE DE TEST ----------------------------------------------------------------\n" );
+    Dataset* tests = DATASET_open( images );
+    if( tests != NULL && checkImageSize( tests, network ) == 0 )
+    {
+        loadImages( tests, cfg->ingest );
+        testing( network, cfg, tests );
+    }
+    else
     {
-        fprintf( stderr, "ERREUR - Format du nom de fichier image incorrect: %s\n", fileName );
-        return( -1 );
+        status = 3;
     }
-    char digit[2];
-    digit[0] = *( ++ptrDash );
-    digit[1] = '\0';
+    DATASET_destroy( tests );
+    printf( "--- FIN PHASE DE TEST ------------------------------------------------------------------\n" );
+
+    // Profil des couches (si compile avec l'instrumentation)
+    PROFILE_report();
+
+    // Liberation memoire
+    CONFIG_destroy( cfg );
+    NETWORK_destroy( network );
+
+    return( status );
+}
+
+
+static int pack( const char* source, const char* fileName )
+{
+    // Ouverture de l'ensemble d'images source
+    Dataset* dataset = DATASET_open( source );
+    if( dataset == NULL ) return( 2 );
+    loadImages( dataset, INGEST_URING );
+
+    // Ecriture du fichier compact
+    printf( "> Compactage de %u images de %s dans %s...\n", dataset->nbSamples, source, fileName );
+    const int status = DATASET_pack( dataset, fileName );
+    if( status == 0 ) printf( "< OK\n" );
+
+    DATASET_destroy( dataset );
+
+    return( status == 0 ? 0 : 3 );
+}
+
+
+static const char* buildName( char* buffer, const Dataset* dataset, uint32_t index )
+{
+    // Nom du fichier si l'image provient d'un repertoire, rang de l'image sinon
+    const char* name = DATASET_getName( dataset, index );
+    if( name != NULL ) return( name );
 
-    return( (int16_t)atoi( digit ) );
+    sprintf( buffer, "image #%u", index );
+    return( buffer );
 }
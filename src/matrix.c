@@ -0,0 +1,143 @@
+#include "ia/matrix.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Local
+#include "ia/kernel.h"
+
+// Dimension des blocs de lignes traites simultanement par les produits de matrices (les valeurs d'un bloc
+// sont gardees en registres ou en cache L1 pendant le parcours des lignes de l'autre matrice)
+#define BLOCK 4
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Real* MATRIX_create( uint32_t nbRows, uint32_t nbColumns )
+{
+    // La taille allouee doit etre un multiple de l'alignement
+    size_t size = (size_t)nbRows * nbColumns * sizeof( Real );
+    size = ( ( size + MATRIX_ALIGNMENT - 1 ) / MATRIX_ALIGNMENT ) * MATRIX_ALIGNMENT;
+    if( size == 0 ) size = MATRIX_ALIGNMENT;
+
+    // Allocation du bloc memoire aligne
+    Real* matrix = (Real*)aligned_alloc( MATRIX_ALIGNMENT, size );
+    if( matrix == NULL )
+    {
+        fprintf( stderr, "ERREUR - Echec d'allocation d'une matrice %ux%u\n", nbRows, nbColumns );
+        return( NULL );
+    }
+    memset( matrix, 0, size );
+
+    return( matrix );
+}
+
+
+void MATRIX_multiplyNT( const Real* a, uint32_t nbRowsA, const Real* b, uint32_t nbRowsB,
+                        uint32_t n, Real* c )
+{
+    // Pour chaque bloc de BLOCK lignes de B
+    for( uint32_t j0 = 0; j0 < nbRowsB; j0 += BLOCK )
+    {
+        const uint32_t nbJ = ( nbRowsB - j0 < BLOCK ? nbRowsB - j0 : BLOCK );
+
+        // Pour chaque bloc de BLOCK lignes de A
+        for( uint32_t i0 = 0; i0 < nbRowsA; i0 += BLOCK )
+        {
+            const uint32_t nbI = ( nbRowsA - i0 < BLOCK ? nbRowsA - i0 : BLOCK );
+
+            // Cas general (bloc complet) : les BLOCK x BLOCK produits scalaires sont calcules en un seul
+            // parcours des lignes, chaque valeur chargee servant BLOCK fois
+            Real sum[BLOCK][BLOCK] = { { 0.0 } };
+            if( nbI == BLOCK && nbJ == BLOCK )
+            {
+                const Real* a0 = a + (size_t)i0 * n;
+                const Real* b0 = b + (size_t)j0 * n;
+                for( uint32_t k = 0; k < n; ++k )
+                {
+                    for( uint32_t i = 0; i < BLOCK; ++i )
+                    {
+                        const Real value = a0[(size_t)i * n + k];
+                        for( uint32_t j = 0; j < BLOCK; ++j ) sum[i][j] += value * b0[(size_t)j * n + k];
+                    }
+                }
+            }
+            else
+            {
+                // Bloc incomplet (bords des matrices, ou lot d'un seul echantillon) : produits scalaires vectorises
+                for( uint32_t i = 0; i < nbI; ++i )
+                {
+                    const Real* rowA = a + (size_t)( i0 + i ) * n;
+                    for( uint32_t j = 0; j < nbJ; ++j )
+                    {
+                        sum[i][j] = KERNEL_dot( rowA, b + (size_t)( j0 + j ) * n, n );
+                    }
+                }
+            }
+
+            // Stockage du bloc resultat
+            for( uint32_t i = 0; i < nbI; ++i )
+            {
+                for( uint32_t j = 0; j < nbJ; ++j ) c[(size_t)( i0 + i ) * nbRowsB + j0 + j] = sum[i][j];
+            }
+        }
+    }
+}
+
+
+void MATRIX_multiplyNN( const Real* a, uint32_t nbRowsA, const Real* b, uint32_t nbColumnsB,
+                        uint32_t n, Real* c )
+{
+    // Pour chaque bloc de BLOCK lignes de C (et de A)
+    for( uint32_t i0 = 0; i0 < nbRowsA; i0 += BLOCK )
+    {
+        const uint32_t nbI = ( nbRowsA - i0 < BLOCK ? nbRowsA - i0 : BLOCK );
+        Real* c0 = c + (size_t)i0 * nbColumnsB;
+        memset( c0, 0, (size_t)nbI * nbColumnsB * sizeof( Real ) );
+
+        // Chaque ligne de B est parcourue une seule fois pour tout le bloc de lignes de C
+        for( uint32_t k = 0; k < n; ++k )
+        {
+            const Real* rowB = b + (size_t)k * nbColumnsB;
+            for( uint32_t i = 0; i < nbI; ++i )
+            {
+                KERNEL_axpy( c0 + (size_t)i * nbColumnsB, a[(size_t)( i0 + i ) * n + k], rowB, nbColumnsB );
+            }
+        }
+    }
+}
+
+
+void MATRIX_accumulateTN( const Real* a, uint32_t nbColumnsA, const Real* b, uint32_t nbColumnsB,
+                          uint32_t n, Real* c )
+{
+    // Pour chaque bloc de BLOCK lignes de C (soit BLOCK colonnes de A)
+    for( uint32_t i0 = 0; i0 < nbColumnsA; i0 += BLOCK )
+    {
+        const uint32_t nbI = ( nbColumnsA - i0 < BLOCK ? nbColumnsA - i0 : BLOCK );
+        Real* c0 = c + (size_t)i0 * nbColumnsB;
+
+        // Chaque ligne de B est parcourue une seule fois pour tout le bloc de lignes de C
+        for( uint32_t k = 0; k < n; ++k )
+        {
+            const Real* rowB = b + (size_t)k * nbColumnsB;
+            for( uint32_t i = 0; i < nbI; ++i )
+            {
+                KERNEL_axpy( c0 + (size_t)i * nbColumnsB, a[(size_t)k * nbColumnsA + i0 + i], rowB, nbColumnsB );
+            }
+        }
+    }
+}
+
+
+void MATRIX_destroy( Real* matrix )
+{
+    // Si valide
+    if( matrix != NULL )
+    {
+        // Liberation memoire
+        free( matrix );
+    }
+}
@@ -4,46 +4,141 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <sys/mman.h>
 
+// Local
+#include "ia/report.h"
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Creation d'un reseau, avec des poids initialises aleatoirement ou fournis (si specifies)
+ *
+ */
+static Network* create( const Config* cfg, Real** weights, Real** bias );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
 
 Network* NETWORK_create( const Config* cfg )
 {
-    // Allocation de la struture de donnees
-    Network* network= (Network*)malloc( sizeof( Network ) );
-    memset( network, 0, sizeof( Network ) );
+    return( create( cfg, NULL, NULL ) );
+}
 
-	// Creation couche d'entree (pas de couche precedente)
-    network->input = LAYER_create( network, cfg->inputSize, NULL );
 
-    // Couche precedente de la couche en cours de creation (pour interconnexion). On initialise avec la
-    // couche d'entree, puis la derniere couche creee devient la precedente de la prochaine...
-    Layer* previous = network->input;
+Network* NETWORK_createMapped( const Config* cfg, Real** weights, Real** bias, void* mapping, size_t mappingSize )
+{
+    Network* network = create( cfg, weights, bias );
+    network->mapping = mapping;
+    network->mappingSize = mappingSize;
 
-    // Creation des couches internes
-    network->nbInternals = cfg->nbLayers;
-    network->internals = (Layer**)malloc( network->nbInternals * sizeof( Layer* ) );
-    for( uint16_t i = 0; i < network->nbInternals; ++i )
+    return( network );
+}
+
+
+void NETWORK_applySample( Network* network, Sample* sample )
+{
+    // Execution du plan d'apprentissage (echantillon etiquete, une etape de mise a jour) ou d'exploitation
+    if( sample->digit >= 0 ) PLAN_run( network->trainingPlan, sample, NETWORK_beginUpdate( network ) );
+    else PLAN_run( network->inferencePlan, sample, 0.0 );
+}
+
+
+void NETWORK_infer( const Network* network, Workspace* workspace, Sample** samples, uint32_t nbSamples )
+{
+    // Le lot doit tenir dans l'espace de travail
+    assert( nbSamples <= workspace->capacity && "Lot d'echantillons trop grand pour l'espace de travail !" );
+
+    // Copie des entrees des echantillons comme sorties de la couche d'entree
+    const uint32_t inputSize = network->input->nbNeurons;
+    for( uint32_t s = 0; s < nbSamples; ++s )
     {
-        network->internals[i] = LAYER_create( network, cfg->internalSize[i], previous );
-        previous = network->internals[i];
+        assert( samples[s]->inputSize == inputSize );
+        memcpy( workspace->outputs[0] + (size_t)s * inputSize, samples[s]->input, inputSize * sizeof( Real ) );
     }
 
-	// Creation couche de sortie (une seule sortie)
-    network->output = LAYER_create( network, cfg->outputSize, previous );
+    // Propagation du lot dans chaque couche
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        LAYER_forwardBatch( layer, nbSamples, workspace->outputs[layer->index - 1],
+                            workspace->outputs[layer->index] );
+    }
+}
 
-    // Copie des parametres du reseau
-    network->learningRate = cfg->learningRate;
-    network->lambda = cfg->lambda;
-printf( "lambda = %f\n", network->lambda );
 
-    return( network );
+int16_t NETWORK_classify( const Network* network, const Workspace* workspace, uint32_t index,
+                          double* probability )
+{
+    // Recherche de la probabilite la plus elevee en sortie
+    const Layer* output = network->output;
+    const Real* values = workspace->outputs[output->index] + (size_t)index * output->nbNeurons;
+    int16_t maxIndex = 0;
+    for( uint32_t i = 1; i < output->nbNeurons; ++i )
+    {
+        if( values[i] > values[maxIndex] ) maxIndex = (int16_t)i;
+    }
+    if( probability != NULL ) *probability = values[maxIndex];
+
+    return( maxIndex );
 }
 
 
-void NETWORK_applySample( Network* network, Sample* sample )
+void NETWORK_computeGradients( const Network* network, Workspace* workspace,
+                               Sample** samples, uint32_t nbSamples )
 {
-    // Envoi de l'echantillon a la couche d'entree du reseau
-    LAYER_applySample( network->input, sample );
+    // Propagation du lot dans chaque couche
+    NETWORK_infer( network, workspace, samples, nbSamples );
+
+    // Initialisation des gradients d'erreur en sortie
+    const Layer* output = network->output;
+    LAYER_initErrorBatch( output, nbSamples, samples, workspace->outputs[output->index],
+                          workspace->errors[output->index] );
+
+    // Retro-propagation vers les couches internes
+    for( const Layer* layer = output->previous; layer->previous != NULL; layer = layer->previous )
+    {
+        LAYER_backwardBatch( layer, nbSamples, workspace->outputs[layer->index],
+                             workspace->errors[layer->index + 1], workspace->errors[layer->index] );
+    }
+
+    // Accumulation des gradients des poids de chaque couche
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        LAYER_accumulateGradients( layer, nbSamples, workspace->errors[layer->index],
+                                   workspace->outputs[layer->index - 1], workspace->gradients[layer->index] );
+    }
+}
+
+
+double NETWORK_beginUpdate( Network* network )
+{
+    // Numero de l'etape (propre a l'appelant, meme si plusieurs threads commencent une etape simultanement)
+    const uint64_t step = atomic_fetch_add( &network->nbUpdates, 1 ) + 1;
+    if( network->optimizer != OPTIMIZER_ADAM ) return( network->learningRate );
+
+    const double t = (double)step;
+    return( network->learningRate * sqrt( 1.0 - pow( network->beta2, t ) ) / ( 1.0 - pow( network->momentum, t ) ) );
+}
+
+
+void NETWORK_applyGradients( Network* network, Workspace* workspace, uint32_t nbSamples )
+{
+    // Mise a jour des poids de chaque couche (une etape)
+    const double stepRate = NETWORK_beginUpdate( network );
+    for( Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        LAYER_applyGradients( layer, nbSamples, workspace->gradients[layer->index], stepRate );
+    }
+}
+
+
+void NETWORK_applyBatch( Network* network, Workspace* workspace, Sample** samples, uint32_t nbSamples )
+{
+    // Calcul des gradients sur l'ensemble du lot, puis mise a jour des poids
+    NETWORK_computeGradients( network, workspace, samples, nbSamples );
+    NETWORK_applyGradients( network, workspace, nbSamples );
 }
 
 
@@ -52,7 +147,9 @@ void NETWORK_destroy( Network* network )
     // Si valide
     if( network != NULL )
     {
-        // Liberation des couches
+        // Liberation des plans d'execution et des couches
+        PLAN_destroy( network->trainingPlan );
+        PLAN_destroy( network->inferencePlan );
         if( network->input ) LAYER_destroy( network->input );
         for( uint16_t i = 0; i < network->nbInternals; ++i )
         {
@@ -60,8 +157,71 @@ void NETWORK_destroy( Network* network )
         }
         if( network->output ) LAYER_destroy( network->output );
 
+        // Liberation de la projection du point de sauvegarde (poids et biais des couches)
+        if( network->mapping != NULL ) munmap( network->mapping, network->mappingSize );
+
         // Liberation memoire
         if( network->internals ) free( network->internals );
         free( network );
     }
 }
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static Network* create( const Config* cfg, Real** weights, Real** bias )
+{
+    // Allocation de la struture de donnees
+    Network* network= (Network*)malloc( sizeof( Network ) );
+    memset( network, 0, sizeof( Network ) );
+
+    atomic_init( &network->nbUpdates, 0 );
+
+    // Graine de l'initialisation des poids (tires a la creation des couches)
+    network->seed = cfg->seed;
+
+    // Methode de mise a jour des poids (l'etat de l'optimiseur est cree avec les couches)
+    network->optimizer = cfg->optimizer;
+    network->momentum = cfg->momentum;
+    network->beta2 = cfg->beta2;
+    network->epsilon = cfg->epsilon;
+
+	// Creation couche d'entree (pas de couche precedente)
+    network->input = LAYER_create( network, cfg->inputSize, NULL );
+
+    // Couche precedente de la couche en cours de creation (pour interconnexion). On initialise avec la
+    // couche d'entree, puis la derniere couche creee devient la precedente de la prochaine...
+    Layer* previous = network->input;
+
+    // Creation des couches internes
+    network->nbInternals = cfg->nbLayers;
+    network->internals = (Layer**)malloc( network->nbInternals * sizeof( Layer* ) );
+    for( uint16_t i = 0; i < network->nbInternals; ++i )
+    {
+        network->internals[i] = ( weights != NULL ?
+                                  LAYER_createMapped( network, cfg->internalSize[i], previous,
+                                                      weights[i + 1], bias[i + 1] ) :
+                                  LAYER_create( network, cfg->internalSize[i], previous ) );
+        previous = network->internals[i];
+    }
+
+	// Creation couche de sortie (une seule sortie)
+    const uint16_t outputIndex = network->nbInternals + 1;
+    network->output = ( weights != NULL ?
+                        LAYER_createMapped( network, cfg->outputSize, previous,
+                                            weights[outputIndex], bias[outputIndex] ) :
+                        LAYER_create( network, cfg->outputSize, previous ) );
+
+    // Copie des parametres du reseau
+    network->learningRate = cfg->learningRate;
+    network->lambda = cfg->lambda;
+    network->fastActivation = cfg->fastActivation;
+    network->batchSize = ( cfg->batchSize > 1 ? cfg->batchSize : 1 );
+    network->verbosity = cfg->verbosity;
+    if( network->verbosity >= REPORT_DEBUG ) fprintf( stdout, "  INFO - lambda = %f\n", network->lambda );
+
+    // Compilation des plans d'execution d'un echantillon
+    network->trainingPlan = PLAN_create( network, 1 );
+    network->inferencePlan = PLAN_create( network, 0 );
+
+    return( network );
+}
@@ -0,0 +1,107 @@
+#include "ia/plan.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Local
+#include "ia/network.h"
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Ajout d'une etape a la fin du plan
+ *
+ */
+static void addStep( Plan* plan, uint8_t operation, Layer* layer );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Plan* PLAN_create( const Network* network, uint8_t training )
+{
+    // Allocation de la struture de donnees. Au plus deux etapes par couche, plus la presentation de l'echantillon
+    // en entree et la perte (ou la copie des sorties)
+    uint32_t nbLayers = 0;
+    for( const Layer* layer = network->input; layer != NULL; layer = layer->next ) nbLayers++;
+    Plan* plan = (Plan*)malloc( sizeof( Plan ) );
+    memset( plan, 0, sizeof( Plan ) );
+    plan->steps = (PlanStep*)malloc( ( 2 * nbLayers + 2 ) * sizeof( PlanStep ) );
+
+    // Presentation de l'echantillon en entree, puis propagation dans chaque couche
+    addStep( plan, PLAN_INPUT, network->input );
+    for( Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        addStep( plan, PLAN_FORWARD, layer );
+    }
+
+    // En exploitation, les sorties obtenues sont simplement copiees dans l'echantillon
+    if( !training )
+    {
+        addStep( plan, PLAN_OUTPUT, network->output );
+        return( plan );
+    }
+
+    // En apprentissage, initialisation des erreurs en sortie, puis retro-propagation et mise a jour des poids
+    // fusionnees, de la couche de sortie a la premiere couche interne. Les erreurs de la couche precedente sont
+    // calculees avec les poids avant leur mise a jour : le resultat est identique a une retro-propagation
+    // complete suivie des mises a jour, mais chaque matrice des poids n'est parcourue qu'une fois
+    addStep( plan, PLAN_LOSS, network->output );
+    for( Layer* layer = network->output; layer->previous != NULL; layer = layer->previous )
+    {
+        addStep( plan, PLAN_BACKWARD_UPDATE, layer );
+    }
+
+    return( plan );
+}
+
+
+void PLAN_run( const Plan* plan, Sample* sample, double stepRate )
+{
+    // Execution des etapes dans l'ordre
+    const PlanStep* step = plan->steps;
+    for( uint32_t i = 0; i < plan->nbSteps; ++i, ++step )
+    {
+        Layer* layer = step->layer;
+        switch( step->operation )
+        {
+            case PLAN_INPUT:
+                LAYER_setInput( layer, sample );
+                break;
+            case PLAN_FORWARD:
+                LAYER_forward( layer, layer->previous->nbNeurons, layer->previous->output );
+                break;
+            case PLAN_LOSS:
+                LAYER_initError( layer, sample );
+                break;
+            case PLAN_OUTPUT:
+                SAMPLE_setOutput( sample, layer->nbNeurons, layer->output );
+                break;
+            case PLAN_BACKWARD_UPDATE:
+                LAYER_backwardUpdate( layer, stepRate );
+                break;
+        }
+    }
+}
+
+
+void PLAN_destroy( Plan* plan )
+{
+    // Si valide
+    if( plan != NULL )
+    {
+        // Liberation memoire
+        free( plan->steps );
+        free( plan );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void addStep( Plan* plan, uint8_t operation, Layer* layer )
+{
+    plan->steps[plan->nbSteps].operation = operation;
+    plan->steps[plan->nbSteps].layer = layer;
+    plan->nbSteps++;
+}
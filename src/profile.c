@@ -0,0 +1,228 @@
+#include "ia/profile.h"
+
+#ifdef IA_PROFILE
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+// Local
+#include "ia/config.h"
+#include "ia/kernel.h"
+#include "ia/matrix.h"
+
+// Nombre max de couches instrumentees (entree, couches internes et sortie)
+#define MAX_LAYERS ( MAX_INTERNALS + 2 )
+
+// Iterations de chaque appel de la mesure de la crete de calcul, et volume de donnees de la mesure de la bande
+// passante memoire (bien au-dela du cache de dernier niveau)
+#define PEAK_ITERATIONS 100000
+#define PEAK_BYTES_SIZE ( 64u * 1024 * 1024 )
+
+// Volume minimal de donnees d'une mesure de bande passante
+#define MIN_BYTES_SIZE 8192
+
+// Duree minimale des mesures des cretes, et des bandes passantes propres a chaque couche (en secondes)
+#define PEAK_DURATION 0.2
+#define LAYER_DURATION 0.05
+
+
+/** Compteurs d'une couche pour une phase
+ *
+ */
+typedef struct
+{
+    _Atomic uint64_t nbCalls;       // Nombre d'appels
+    _Atomic uint64_t duration;      // Duree cumulee (en ns, tous threads confondus)
+    _Atomic uint64_t flop;          // Nombre d'operations flottantes
+    _Atomic uint64_t bytes;         // Nombre d'octets lus ou ecrits
+} Counter;
+
+/** Compteurs d'une couche
+ *
+ */
+typedef struct
+{
+    uint32_t nbInputs;                      // Nombre d'entrees des neurones de la couche
+    uint32_t nbNeurons;                     // Nombre de neurones de la couche
+    Counter phases[PROFILE_NB_PHASES];      // Compteurs de chaque phase
+} LayerCounters;
+
+// Compteurs de toutes les couches
+static LayerCounters counters[MAX_LAYERS];
+
+// Noms des phases
+static const char* PHASE_NAMES[PROFILE_NB_PHASES] = { "propagation", "retropropagation", "gradients",
+                                                      "mise a jour", "retro+maj" };
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Mesure de la crete de calcul d'un coeur (GFLOP/s) : multiplications-additions independantes sur des
+ *  registres (voir KERNEL_peak()), sans acces a la memoire
+ *
+ */
+static double measurePeakFlops();
+
+/** Mesure de la bande passante (Go/s) pour le volume de donnees specifie : produits scalaires repetes sur deux
+ *  vecteurs de ce volume total
+ *
+ *  Au-dela du cache de dernier niveau, on obtient la bande passante memoire. En dessous, celle du niveau de
+ *  cache qui contient les donnees
+ */
+static double measureBandwidth( size_t bytes, double minDuration );
+
+/** Lecture d'une crete fournie par une variable d'environnement (0 si absente)
+ *
+ */
+static double readPeak( const char* name );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+uint64_t PROFILE_now()
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return( (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec );
+}
+
+
+void PROFILE_add( uint16_t layer, uint32_t nbInputs, uint32_t nbNeurons, uint8_t phase, uint64_t duration,
+                  uint64_t flop, uint64_t bytes )
+{
+    if( layer >= MAX_LAYERS ) return;
+
+    // Dimensions de la couche (identiques pour tous les appels)
+    LayerCounters* layerCounters = &counters[layer];
+    layerCounters->nbInputs = nbInputs;
+    layerCounters->nbNeurons = nbNeurons;
+
+    // Cumul des compteurs de la phase
+    Counter* counter = &layerCounters->phases[phase];
+    atomic_fetch_add_explicit( &counter->nbCalls, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &counter->duration, duration, memory_order_relaxed );
+    atomic_fetch_add_explicit( &counter->flop, flop, memory_order_relaxed );
+    atomic_fetch_add_explicit( &counter->bytes, bytes, memory_order_relaxed );
+}
+
+
+void PROFILE_report()
+{
+    // Cretes de la machine (fournies, ou mesurees sur un coeur avec les noyaux de calcul selectionnes)
+    double peakFlops = readPeak( "IA_PEAK_GFLOPS" );
+    double peakBandwidth = readPeak( "IA_PEAK_GBS" );
+    if( peakFlops <= 0.0 ) peakFlops = measurePeakFlops();
+    const uint8_t fixedBandwidth = ( peakBandwidth > 0.0 );
+    if( !fixedBandwidth ) peakBandwidth = measureBandwidth( PEAK_BYTES_SIZE, PEAK_DURATION );
+
+    // Duree totale instrumentee (pour la part de chaque ligne)
+    double total = 0.0;
+    for( uint16_t i = 0; i < MAX_LAYERS; ++i )
+    {
+        for( uint8_t p = 0; p < PROFILE_NB_PHASES; ++p ) total += atomic_load( &counters[i].phases[p].duration );
+    }
+
+    fprintf( stdout, "--- PROFIL DES COUCHES ----------------------------------------------------------------\n" );
+    fprintf( stdout, "INFO - Cretes (%s, %s) : %.2f GFLOP/s, %.2f Go/s (point d'equilibre %.2f FLOP/octet)\n",
+             KERNEL_name(), REAL_NAME, peakFlops, peakBandwidth, peakFlops / peakBandwidth );
+    fprintf( stdout, "INFO - Le plafond de chaque couche tient compte de la bande passante mesuree pour le volume "
+             "de sa matrice des poids (cache ou memoire)\n" );
+    fprintf( stdout, "%-8s %-10s %-16s %10s %10s %6s %9s %9s %9s %8s %9s %6s %s\n", "couche", "dimensions", "phase",
+             "appels", "duree(ms)", "part", "GFLOP/s", "Go/s", "Go/s max", "FLOP/o", "plafond", "eff.", "limite" );
+
+    // Une ligne par couche et par phase mesuree
+    for( uint16_t i = 0; i < MAX_LAYERS; ++i )
+    {
+        // Bande passante disponible pour le volume de la matrice des poids de la couche (si elle a ete mesuree)
+        uint64_t nbCalls = 0;
+        for( uint8_t p = 0; p < PROFILE_NB_PHASES; ++p ) nbCalls += atomic_load( &counters[i].phases[p].nbCalls );
+        if( nbCalls == 0 ) continue;
+        const size_t footprint = (size_t)counters[i].nbInputs * counters[i].nbNeurons * sizeof( Real );
+        const double bandwidth = ( fixedBandwidth ? peakBandwidth : measureBandwidth( footprint, LAYER_DURATION ) );
+
+        for( uint8_t p = 0; p < PROFILE_NB_PHASES; ++p )
+        {
+            const Counter* counter = &counters[i].phases[p];
+            const uint64_t nbPhaseCalls = atomic_load( &counter->nbCalls );
+            if( nbPhaseCalls == 0 ) continue;
+
+            // Debits obtenus, intensite arithmetique, et plafond du modele roofline pour cette intensite
+            const double duration = (double)atomic_load( &counter->duration );
+            const double flop = (double)atomic_load( &counter->flop );
+            const double bytes = (double)atomic_load( &counter->bytes );
+            const double gflops = ( duration > 0.0 ? flop / duration : 0.0 );
+            const double gbs = ( duration > 0.0 ? bytes / duration : 0.0 );
+            const double intensity = ( bytes > 0.0 ? flop / bytes : 0.0 );
+            const double memoryCeiling = intensity * bandwidth;
+            const double ceiling = ( memoryCeiling < peakFlops ? memoryCeiling : peakFlops );
+
+            char dimensions[32];
+            snprintf( dimensions, sizeof( dimensions ), "%ux%u", counters[i].nbInputs, counters[i].nbNeurons );
+            fprintf( stdout, "%-8u %-10s %-16s %10llu %10.1f %5.1f%% %9.2f %9.2f %9.2f %8.3f %9.2f %5.1f%% %s\n",
+                     i, dimensions, PHASE_NAMES[p], (unsigned long long)nbPhaseCalls, duration * 1e-6,
+                     100.0 * duration / total, gflops, gbs, bandwidth, intensity, ceiling,
+                     ( ceiling > 0.0 ? 100.0 * gflops / ceiling : 0.0 ),
+                     ( memoryCeiling < peakFlops ? "memoire" : "calcul" ) );
+        }
+    }
+    fprintf( stdout, "INFO - Durees cumulees sur tous les threads, debits rapportes a un coeur\n" );
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static double measurePeakFlops()
+{
+    // Multiplications-additions repetees jusqu'a la duree minimale
+    volatile Real sink = 0;
+    uint64_t flop = 0;
+    const uint64_t start = PROFILE_now();
+    uint64_t duration = 0;
+    do
+    {
+        Real result = 0;
+        flop += KERNEL_peak( PEAK_ITERATIONS, &result );
+        sink += result;
+        duration = PROFILE_now() - start;
+    } while( duration < PEAK_DURATION * 1e9 );
+
+    return( (double)flop / duration );
+}
+
+
+static double measureBandwidth( size_t bytes, double minDuration )
+{
+    // Vecteurs du volume specifie (initialises, de sorte que les pages soient allouees)
+    if( bytes < MIN_BYTES_SIZE ) bytes = MIN_BYTES_SIZE;
+    const uint32_t size = (uint32_t)( bytes / ( 2 * sizeof( Real ) ) );
+    Real* x = MATRIX_create( 2, size );
+    Real* y = x + size;
+    for( uint32_t i = 0; i < 2 * size; ++i ) x[i] = (Real)( i & 7 ) * (Real)0.125;
+
+    // Produits scalaires repetes (lecture des deux vecteurs) jusqu'a la duree minimale
+    volatile Real sink = 0;
+    uint64_t nbCalls = 0;
+    const uint64_t start = PROFILE_now();
+    uint64_t duration = 0;
+    do
+    {
+        sink += KERNEL_dot( x, y, size );
+        nbCalls++;
+        duration = PROFILE_now() - start;
+    } while( duration < minDuration * 1e9 );
+    MATRIX_destroy( x );
+
+    return( 2.0 * size * sizeof( Real ) * nbCalls / duration );
+}
+
+
+static double readPeak( const char* name )
+{
+    const char* value = getenv( name );
+    return( value != NULL ? atof( value ) : 0.0 );
+}
+
+#endif // IA_PROFILE
@@ -0,0 +1,204 @@
+#include "ia/quantized.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Local
+#include "ia/kernel.h"
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Quantification d'une couche du reseau
+ *
+ */
+static void quantizeLayer( QuantizedLayer* quantized, const Layer* layer );
+
+/** Quantification d'une activation (comprise entre 0 et 1)
+ *
+ */
+static uint8_t quantizeActivation( double value );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+QuantizedNetwork* QUANTIZED_create( const Network* network )
+{
+    // Allocation de la struture de donnees
+    QuantizedNetwork* quantized = (QuantizedNetwork*)malloc( sizeof( QuantizedNetwork ) );
+    memset( quantized, 0, sizeof( QuantizedNetwork ) );
+    quantized->inputSize = network->input->nbNeurons;
+    quantized->lambda = network->lambda;
+
+    // Quantification de chaque couche ayant des poids (couches internes et couche de sortie)
+    quantized->nbLayers = network->nbInternals + 1;
+    quantized->layers = (QuantizedLayer*)calloc( quantized->nbLayers, sizeof( QuantizedLayer ) );
+    quantized->maxSize = quantized->inputSize;
+    uint16_t i = 0;
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        quantizeLayer( &quantized->layers[i++], layer );
+        if( layer->nbNeurons > quantized->maxSize ) quantized->maxSize = layer->nbNeurons;
+    }
+
+    return( quantized );
+}
+
+
+size_t QUANTIZED_size( const QuantizedNetwork* network )
+{
+    size_t size = 0;
+    for( uint16_t i = 0; i < network->nbLayers; ++i )
+    {
+        const QuantizedLayer* layer = &network->layers[i];
+        size += (size_t)layer->nbNeurons * layer->nbInputs * sizeof( int8_t );
+        size += (size_t)layer->nbNeurons * 2 * sizeof( float );
+    }
+
+    return( size );
+}
+
+
+QuantizedScratch* QUANTIZED_createScratch( const QuantizedNetwork* network )
+{
+    // Allocation de la struture de donnees
+    QuantizedScratch* scratch = (QuantizedScratch*)malloc( sizeof( QuantizedScratch ) );
+    memset( scratch, 0, sizeof( QuantizedScratch ) );
+
+    // Buffers dimensionnes pour la plus grande couche
+    scratch->activations[0] = (uint8_t*)malloc( network->maxSize * sizeof( uint8_t ) );
+    scratch->activations[1] = (uint8_t*)malloc( network->maxSize * sizeof( uint8_t ) );
+    scratch->values = (float*)malloc( network->maxSize * sizeof( float ) );
+
+    return( scratch );
+}
+
+
+int16_t QUANTIZED_classify( const QuantizedNetwork* network, QuantizedScratch* scratch,
+                            const Sample* sample, double* probability )
+{
+    // Quantification des entrees de l'echantillon
+    uint8_t* inputs = scratch->activations[0];
+    uint8_t* outputs = scratch->activations[1];
+    for( uint32_t i = 0; i < network->inputSize; ++i ) inputs[i] = quantizeActivation( sample->input[i] );
+
+    // Pour chaque couche
+    float* values = scratch->values;
+    for( uint16_t l = 0; l < network->nbLayers; ++l )
+    {
+        // Sommes ponderees : produit scalaire entier, remis a l'echelle des poids et des activations
+        const QuantizedLayer* layer = &network->layers[l];
+        for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+        {
+            const int32_t sum = KERNEL_dotInt8( inputs, layer->weights + (size_t)i * layer->nbInputs, layer->nbInputs );
+            values[i] = (float)sum * layer->scales[i] * ( 1.0f / QUANTIZED_ONE ) + layer->bias[i];
+        }
+
+        // Couches internes : sigmoide, et quantification des sorties pour la couche suivante
+        if( l + 1 < network->nbLayers )
+        {
+            for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+            {
+                outputs[i] = quantizeActivation( 1.0 / ( 1.0 + exp( - network->lambda * values[i] ) ) );
+            }
+            uint8_t* swap = inputs;
+            inputs = outputs;
+            outputs = swap;
+        }
+    }
+
+    // Couche de sortie : le chiffre identifie est celui de plus grande somme ponderee (SOFTMAX etant
+    // croissante), et sa probabilite est calculee par SOFTMAX (maximum soustrait avant les exponentielles)
+    const QuantizedLayer* output = &network->layers[network->nbLayers - 1];
+    uint32_t maxIndex = 0;
+    for( uint32_t i = 1; i < output->nbNeurons; ++i )
+    {
+        if( values[i] > values[maxIndex] ) maxIndex = i;
+    }
+    if( probability != NULL )
+    {
+        double denominator = 0.0;
+        for( uint32_t i = 0; i < output->nbNeurons; ++i ) denominator += exp( values[i] - values[maxIndex] );
+        *probability = 1.0 / denominator;
+    }
+
+    return( (int16_t)maxIndex );
+}
+
+
+void QUANTIZED_destroyScratch( QuantizedScratch* scratch )
+{
+    // Si valide
+    if( scratch != NULL )
+    {
+        // Liberation memoire
+        free( scratch->activations[0] );
+        free( scratch->activations[1] );
+        free( scratch->values );
+        free( scratch );
+    }
+}
+
+
+void QUANTIZED_destroy( QuantizedNetwork* network )
+{
+    // Si valide
+    if( network != NULL )
+    {
+        // Liberation des couches
+        for( uint16_t i = 0; i < network->nbLayers; ++i )
+        {
+            free( network->layers[i].weights );
+            free( network->layers[i].scales );
+            free( network->layers[i].bias );
+        }
+
+        // Liberation memoire
+        free( network->layers );
+        free( network );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void quantizeLayer( QuantizedLayer* quantized, const Layer* layer )
+{
+    quantized->nbNeurons = layer->nbNeurons;
+    quantized->nbInputs = layer->nbInputs;
+    quantized->weights = (int8_t*)malloc( (size_t)layer->nbNeurons * layer->nbInputs * sizeof( int8_t ) );
+    quantized->scales = (float*)malloc( layer->nbNeurons * sizeof( float ) );
+    quantized->bias = (float*)malloc( layer->nbNeurons * sizeof( float ) );
+
+    // Pour chaque neurone (ligne de la matrice des poids)
+    for( uint32_t i = 0; i < layer->nbNeurons; ++i )
+    {
+        // L'echelle de la ligne est choisie de sorte que le poids de plus grande valeur absolue vaille 127
+        const Real* row = layer->weights + (size_t)i * layer->nbInputs;
+        double maxValue = 0.0;
+        for( uint32_t j = 0; j < layer->nbInputs; ++j )
+        {
+            if( fabs( row[j] ) > maxValue ) maxValue = fabs( row[j] );
+        }
+        const double scale = ( maxValue > 0.0 ? maxValue / 127.0 : 1.0 );
+
+        // Quantification des poids (arrondi au plus proche)
+        int8_t* quantizedRow = quantized->weights + (size_t)i * layer->nbInputs;
+        for( uint32_t j = 0; j < layer->nbInputs; ++j ) quantizedRow[j] = (int8_t)lrint( row[j] / scale );
+        quantized->scales[i] = (float)scale;
+        quantized->bias[i] = (float)layer->bias[i];
+    }
+}
+
+
+static uint8_t quantizeActivation( double value )
+{
+    // Arrondi au plus proche, borne a l'intervalle 0..QUANTIZED_ONE
+    const long quantized = lrint( value * QUANTIZED_ONE );
+    if( quantized < 0 ) return( 0 );
+    if( quantized > QUANTIZED_ONE ) return( QUANTIZED_ONE );
+
+    return( (uint8_t)quantized );
+}
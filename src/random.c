@@ -0,0 +1,81 @@
+#include "ia/random.h"
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Generateur SplitMix64 (etat mis a jour, et valeur suivante retournee)
+ *
+ */
+static uint64_t splitMix( uint64_t* state );
+
+/** Rotation a gauche de k bits d'un entier de 64 bits
+ *
+ */
+static inline uint64_t rotate( uint64_t x, int k );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+void RANDOM_seed( Random* random, uint64_t seed, uint64_t stream )
+{
+    // Le numero de flux est melange avant d'etre combine a la graine : des flux consecutifs partent de points
+    // eloignes de la suite SplitMix64, et leurs etats n'ont aucune valeur commune
+    uint64_t mixed = stream;
+    uint64_t state = seed ^ splitMix( &mixed );
+    for( uint32_t i = 0; i < 4; ++i ) random->state[i] = splitMix( &state );
+}
+
+
+uint64_t RANDOM_next( Random* random )
+{
+    uint64_t* s = random->state;
+    const uint64_t result = rotate( s[1] * 5, 7 ) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate( s[3], 45 );
+
+    return( result );
+}
+
+
+double RANDOM_uniform( Random* random )
+{
+    return( ( RANDOM_next( random ) >> 11 ) * 0x1.0p-53 );
+}
+
+
+uint32_t RANDOM_below( Random* random, uint32_t n )
+{
+    // Methode de Lemire : les 32 bits de poids fort du produit d'un tirage de 32 bits par n sont dans [0, n[.
+    // Les produits dont la partie basse est inferieure a 2^32 mod n sont rejetes (probabilite au plus n / 2^32),
+    // ce qui rend chaque valeur exactement equiprobable. Le modulo n'est calcule qu'en cas de rejet possible
+    uint64_t product = ( RANDOM_next( random ) >> 32 ) * n;
+    if( (uint32_t)product < n )
+    {
+        const uint32_t threshold = (uint32_t)( -n ) % n;
+        while( (uint32_t)product < threshold ) product = ( RANDOM_next( random ) >> 32 ) * n;
+    }
+
+    return( (uint32_t)( product >> 32 ) );
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static uint64_t splitMix( uint64_t* state )
+{
+    uint64_t z = ( *state += 0x9E3779B97F4A7C15ull );
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+
+    return( z ^ ( z >> 31 ) );
+}
+
+
+static inline uint64_t rotate( uint64_t x, int k )
+{
+    return( ( x << k ) | ( x >> ( 64 - k ) ) );
+}
@@ -0,0 +1,177 @@
+#include "ia/report.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Borne inferieure des probabilites dans le calcul de la perte (evite log( 0 ))
+#define MIN_PROBABILITY 1e-12
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Emission des statistiques specifiees
+ *
+ *  Le type d'emission est "progression" (statistiques periodiques) ou "bilan" (fin de phase)
+ */
+static void emit( const Report* report, const char* event, const ReportStats* stats );
+
+/** Reinitialisation de statistiques (et debut de la periode)
+ *
+ */
+static void reset( ReportStats* stats );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Report* REPORT_create( const Config* cfg )
+{
+    // Allocation de la struture de donnees
+    Report* report = (Report*)malloc( sizeof( Report ) );
+    memset( report, 0, sizeof( Report ) );
+    report->json = cfg->reportJson;
+    report->interval = cfg->reportInterval;
+    pthread_mutex_init( &report->mutex, NULL );
+
+    return( report );
+}
+
+
+void REPORT_begin( Report* report, const char* phase, uint64_t nbExpected )
+{
+    report->phase = phase;
+    report->nbExpected = nbExpected;
+    report->nextEmission = report->interval;
+    reset( &report->total );
+    reset( &report->window );
+}
+
+
+double REPORT_loss( const Real* outputs, uint32_t nbOutputs, int16_t digit, uint8_t* correct )
+{
+    // Recherche du chiffre de plus forte probabilite
+    uint32_t maxIndex = 0;
+    for( uint32_t i = 1; i < nbOutputs; ++i )
+    {
+        if( outputs[i] > outputs[maxIndex] ) maxIndex = i;
+    }
+    if( correct != NULL ) *correct = ( (int16_t)maxIndex == digit );
+
+    // Entropie croisee : - log( probabilite du chiffre attendu )
+    const double probability = outputs[digit];
+    return( -log( probability > MIN_PROBABILITY ? probability : MIN_PROBABILITY ) );
+}
+
+
+void REPORT_add( Report* report, uint32_t nbSamples, uint32_t nbCorrect, double loss, uint32_t nbLoss )
+{
+    pthread_mutex_lock( &report->mutex );
+
+    // Cumul des statistiques
+    ReportStats* all[2] = { &report->total, &report->window };
+    for( uint32_t i = 0; i < 2; ++i )
+    {
+        all[i]->nbSamples += nbSamples;
+        all[i]->nbCorrect += nbCorrect;
+        all[i]->loss += loss;
+        all[i]->nbLoss += nbLoss;
+    }
+
+    // Emission des statistiques de la periode, si l'intervalle est atteint
+    if( report->interval > 0 && report->total.nbSamples >= report->nextEmission )
+    {
+        emit( report, "progression", &report->window );
+        reset( &report->window );
+        while( report->nextEmission <= report->total.nbSamples ) report->nextEmission += report->interval;
+    }
+
+    pthread_mutex_unlock( &report->mutex );
+}
+
+
+void REPORT_addBatch( Report* report, const Real* outputs, uint32_t nbOutputs, Sample** samples,
+                      uint32_t nbSamples )
+{
+    // Perte et classification de chaque echantillon, puis ajout au suivi en une seule fois
+    double loss = 0.0;
+    uint32_t nbCorrect = 0;
+    for( uint32_t i = 0; i < nbSamples; ++i )
+    {
+        uint8_t correct = 0;
+        loss += REPORT_loss( outputs + (size_t)i * nbOutputs, nbOutputs, samples[i]->digit, &correct );
+        nbCorrect += correct;
+    }
+    REPORT_add( report, nbSamples, nbCorrect, loss, nbSamples );
+}
+
+
+void REPORT_end( Report* report )
+{
+    emit( report, "bilan", &report->total );
+    fflush( stdout );
+}
+
+
+void REPORT_destroy( Report* report )
+{
+    // Si valide
+    if( report != NULL )
+    {
+        // Liberation memoire
+        pthread_mutex_destroy( &report->mutex );
+        free( report );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void emit( const Report* report, const char* event, const ReportStats* stats )
+{
+    // Duree de la periode, et statistiques moyennes
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    const double duration = ( now.tv_sec - stats->start.tv_sec ) + ( now.tv_nsec - stats->start.tv_nsec ) * 1e-9;
+    const double rate = ( duration > 0.0 ? stats->nbSamples / duration : 0.0 );
+    const double accuracy = ( stats->nbSamples > 0 ? 100.0 * stats->nbCorrect / stats->nbSamples : 0.0 );
+    const double loss = ( stats->nbLoss > 0 ? stats->loss / stats->nbLoss : NAN );
+
+    // Ligne emise d'un seul tenant (les validations sont suivies depuis un autre thread que l'apprentissage)
+    flockfile( stdout );
+    if( report->json )
+    {
+        // Une ligne JSON par emission (la perte vaut null si elle n'est pas connue)
+        char lossText[32];
+        if( stats->nbLoss > 0 ) snprintf( lossText, sizeof( lossText ), "%.6f", loss );
+        else strcpy( lossText, "null" );
+        fprintf( stdout, "{\"phase\":\"%s\",", report->phase );
+        if( report->epoch > 0 ) fprintf( stdout, "\"epoch\":%u,", report->epoch );
+        fprintf( stdout, "\"event\":\"%s\",\"samples\":%llu,\"done\":%llu,\"expected\":%llu,"
+                 "\"loss\":%s,\"accuracy\":%.4f,\"samples_per_sec\":%.1f,\"seconds\":%.6f}\n",
+                 event, (unsigned long long)stats->nbSamples,
+                 (unsigned long long)report->total.nbSamples, (unsigned long long)report->nbExpected,
+                 lossText, accuracy, rate, duration );
+    }
+    else
+    {
+        // Texte lisible
+        fprintf( stdout, "INFO [%s", report->phase );
+        if( report->epoch > 0 ) fprintf( stdout, ", epoque %u", report->epoch );
+        fprintf( stdout, "] %s : %llu/%llu echantillons", event,
+                 (unsigned long long)report->total.nbSamples, (unsigned long long)report->nbExpected );
+        if( stats->nbLoss > 0 ) fprintf( stdout, ", perte = %.4f", loss );
+        fprintf( stdout, ", precision = %.2f %%, %.0f echantillons/s\n", accuracy, rate );
+    }
+    funlockfile( stdout );
+}
+
+
+static void reset( ReportStats* stats )
+{
+    stats->nbSamples = 0;
+    stats->nbCorrect = 0;
+    stats->nbLoss = 0;
+    stats->loss = 0.0;
+    clock_gettime( CLOCK_MONOTONIC, &stats->start );
+}
@@ -4,66 +4,179 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
 
-// Dimensions des images
-#define IMAGE_WIDTH 28
-#define IMAGE_HEIGHT 28
+// Local
+#include "ia/matrix.h"
 
 
 //--- Declaration des fonctions locales ------------------------------------------------------------------------
 
-/** Charge l'image specifiee et initialise les entrees de l'echantillon
+/** Initialise les sorties attendues de l'echantillon en fonction du chiffre specifie
  *
+ *  Si le chiffre n'est pas compris entre 0 et 9, l'echantillon n'a pas de sorties attendues (phase de test)
  */
-static int loadImage( Sample* sample, const char* imageFile );
+static void initOutput( Sample* sample, int16_t digit );
 
 
 //--- Fonctions publiques --------------------------------------------------------------------------------------
 
-Sample* SAMPLE_create( const char* imageFile, int16_t digit )
+Sample* SAMPLE_createEmpty( uint32_t inputSize, uint32_t outputSize )
 {
     // Allocation de la struture de donnees
     Sample* sample= (Sample*)malloc( sizeof( Sample ) );
     memset( sample, 0, sizeof( Sample ) );
 
-	// Chargement de l'image et initialisation des entrees
-	if( loadImage( sample, imageFile ) != 0 )
+    // Allocation memoire (alignee) pour les entrees et sorties de l'echantillon
+    sample->inputSize = inputSize;
+    sample->inputCapacity = inputSize;
+    sample->input = MATRIX_create( 1, inputSize );
+    sample->nonZeroIndexes = (uint32_t*)malloc( inputSize * sizeof( uint32_t ) );
+    sample->nonZeroValues = MATRIX_create( 1, inputSize );
+    sample->outputSize = outputSize;
+    sample->output = MATRIX_create( 1, outputSize );
+    sample->digit = -1;
+
+    return( sample );
+}
+
+
+Sample** SAMPLE_createPool( uint32_t nbSamples, uint32_t inputSize, uint32_t outputSize )
+{
+    Sample** pool = (Sample**)malloc( nbSamples * sizeof( Sample* ) );
+    for( uint32_t i = 0; i < nbSamples; ++i ) pool[i] = SAMPLE_createEmpty( inputSize, outputSize );
+
+    return( pool );
+}
+
+
+Sample* SAMPLE_create( const char* imageFile, int16_t digit )
+{
+    // Creation de l'echantillon, et chargement de l'image
+    Sample* sample = SAMPLE_createEmpty( SAMPLE_IMAGE_SIZE, SAMPLE_OUTPUT_SIZE );
+    if( SAMPLE_load( sample, imageFile, digit ) != 0 )
     {
-        free( sample );
+        SAMPLE_destroy( sample );
         return( NULL );
     }
 
-    // Si un chiffre entre 0 et 9 est specifie
-    if( digit >= 0 && digit <= 9 )
-    {
-        // Copie du chiffre
-        sample->digit = digit;
+    return( sample );
+}
 
-        // Initialisation des sorties attendues pour l'echantillon
-        const int outputSize = 10;
-        sample->outputSize = outputSize;
-        sample->output = (double*)malloc( outputSize * sizeof( double ) );
-        for( uint16_t i = 0; i < outputSize; ++i )
+
+Sample* SAMPLE_createFromPixels( const uint8_t* pixels, uint32_t nbPixels, uint32_t maxValue, int16_t digit )
+{
+    // Creation de l'echantillon, et chargement des pixels de l'image
+    Sample* sample = SAMPLE_createEmpty( nbPixels, SAMPLE_OUTPUT_SIZE );
+    SAMPLE_setPixels( sample, pixels, nbPixels, maxValue, digit );
+
+    return( sample );
+}
+
+
+int SAMPLE_load( Sample* sample, const char* imageFile, int16_t digit )
+{
+	// Chargement de l'image
+    uint8_t pixels[SAMPLE_IMAGE_SIZE];
+    uint32_t maxValue = 0;
+	if( SAMPLE_readImage( imageFile, pixels, &maxValue ) != 0 ) return( 1 );
+
+    // Normalisation des pixels de l'image dans l'echantillon
+    SAMPLE_setPixels( sample, pixels, SAMPLE_IMAGE_SIZE, maxValue, digit );
+
+    return( 0 );
+}
+
+
+void SAMPLE_setPixels( Sample* sample, const uint8_t* pixels, uint32_t nbPixels, uint32_t maxValue, int16_t digit )
+{
+    // Les entrees allouees de l'echantillon doivent pouvoir contenir tous les pixels (la capacite n'est pas
+    // modifiee : une image plus courte ne reduit pas l'echantillon pour les suivantes)
+    assert( nbPixels <= sample->inputCapacity && "Image trop grande pour l'echantillon !" );
+    sample->inputSize = nbPixels;
+
+    // Normalisation et stockage de pixels comme entrees de l'echantillon, et liste des entrees non nulles
+    sample->nbNonZero = 0;
+    for( uint32_t i = 0; i < sample->inputSize; ++i )
+    {
+        sample->input[i] = (Real)pixels[i] / (Real)maxValue;
+        if( pixels[i] != 0 )
         {
-            // La probabilite est a 1 pour le chiffre fourni et 0 pour les autres
-            sample->output[i] = ( i == digit ? 1.0 : 0.0 );
+            sample->nonZeroIndexes[sample->nbNonZero] = i;
+            sample->nonZeroValues[sample->nbNonZero++] = sample->input[i];
         }
     }
-    else
+
+    // Initialisation des sorties attendues (si l'echantillon est etiquete)
+    initOutput( sample, digit );
+}
+
+
+int SAMPLE_readImage( const char* imageFile, uint8_t* pixels, uint32_t* maxValue )
+{
+    // Ouverture du fichier image (lecture directe, sans buffer d'entree/sortie alloue)
+    const int fd = open( imageFile, O_RDONLY );
+    if( fd < 0 )
     {
-        // Pas d'etiquette (echantillon de test)
-        sample->digit = -1;
+        fprintf( stderr, "ERREUR - Impossible d'ouvrir le fichier image : %s\n", imageFile );
+        return( 1 );
     }
 
-    return( sample );
+    // Lecture de l'image complete (en-tete et pixels)
+    uint8_t buffer[SAMPLE_PGM_MAX_SIZE + 1];
+    ssize_t size = 0, nbRead = 0;
+    while( size < (ssize_t)sizeof( buffer ) - 1 &&
+           ( nbRead = read( fd, buffer + size, sizeof( buffer ) - 1 - size ) ) > 0 )
+    {
+        size += nbRead;
+    }
+    close( fd );
+    buffer[size < 0 ? 0 : size] = '\0';
+
+    // Decodage de l'image
+    return( SAMPLE_parseImage( imageFile, buffer, (size_t)( size < 0 ? 0 : size ), pixels, maxValue ) );
 }
 
 
-void SAMPLE_setOutput( Sample* sample, uint32_t nbValues, const double* values )
+int SAMPLE_parseImage( const char* imageFile, const uint8_t* data, size_t size, uint8_t* pixels,
+                       uint32_t* maxValue )
 {
-    // Allocation memoire
+    // Lecture en-tete : identifiant, dimensions, valeur max, puis un caractere separateur avant les pixels
+    char magic[3];
+    int width = 0, height = 0, max = 0, headerSize = 0;
+    sscanf( (const char*)data, "%2s %d %d %d%n", magic, &width, &height, &max, &headerSize );
+
+    // Verification dimensions image
+    if( width != SAMPLE_IMAGE_WIDTH || height!= SAMPLE_IMAGE_HEIGHT )
+    {
+        fprintf( stderr, "ERREUR - Dimensions d'image incorrectes: %dx%d\n", width, height );
+        return( 2 );
+    }
+
+    // Lecture des pixels
+    if( headerSize == 0 || (size_t)headerSize + 1 + SAMPLE_IMAGE_SIZE > size )
+    {
+        fprintf( stderr, "ERREUR - Echec lecture fichier image: %s\n", imageFile );
+        return( 3 );
+    }
+    memcpy( pixels, data + headerSize + 1, SAMPLE_IMAGE_SIZE );
+    *maxValue = (uint32_t)max;
+
+    return( 0 );
+}
+
+
+void SAMPLE_setOutput( Sample* sample, uint32_t nbValues, const Real* values )
+{
+    // Allocation memoire (uniquement si le buffer de l'echantillon est trop petit)
+    if( nbValues > sample->outputSize )
+    {
+        MATRIX_destroy( sample->output );
+        sample->output = MATRIX_create( 1, nbValues );
+    }
     sample->outputSize = nbValues;
-    sample->output = (double*)malloc( nbValues * sizeof( double ) );
 
     // Calcul de la somme de valeurs
     double sum = 0.0;
@@ -83,58 +196,50 @@ void SAMPLE_destroy( Sample* sample )
     if( sample != NULL )
     {
         // Liberation memoire
-        if( sample->input ) free( sample->input );
-        if( sample->output ) free( sample->output );
+        MATRIX_destroy( sample->input );
+        MATRIX_destroy( sample->nonZeroValues );
+        free( sample->nonZeroIndexes );
+        MATRIX_destroy( sample->output );
         free( sample );
     }
 }
 
-//--- Fonctions locales ----------------------------------------------------------------------------------------
 
-static int loadImage( Sample* sample, const char* imageFile )
+void SAMPLE_destroyPool( Sample** pool, uint32_t nbSamples )
 {
-    // Ouverture du fichier image
-    FILE* file = fopen( imageFile, "rb" );
-    if( file == NULL )
+    // Si valide
+    if( pool != NULL )
     {
-        fprintf( stderr, "ERREUR - Impossible d'ouvrir le fichier image : %s\n", imageFile );
-        return( 1 );
-    }
+        // Liberation des echantillons
+        for( uint32_t i = 0; i < nbSamples; ++i ) SAMPLE_destroy( pool[i] );
 
-    // Lecture en-tete
-    char magic[3];
-    int width = 0, height = 0, maxValue = 0;
-    fscanf( file, "%2s\n", magic );
-    fscanf( file, "%d %d\n", &width, &height );
-    fscanf( file, "%d\n", &maxValue );
-
-    // Verification dimensions image
-    if( width != IMAGE_WIDTH || height!= IMAGE_HEIGHT )
-    {
-        fprintf( stderr, "ERREUR - Dimensions d'image incorrectes: %dx%d\n", width, height );
-        return( 2 );
+        // Liberation memoire
+        free( pool );
     }
+}
 
-    // Allocation memoire pour les entrees de l'echantillon
-    sample->inputSize = (uint32_t)( width * height );
-    sample->input = (double*)malloc( sample->inputSize * sizeof( double ) );
+//--- Fonctions locales ----------------------------------------------------------------------------------------
 
-    // Lecture des pixels
-    unsigned char buff[784];
-    if( fread( buff, 784, 1, file ) != 1 )
+static void initOutput( Sample* sample, int16_t digit )
+{
+    // Si un chiffre entre 0 et 9 est specifie
+    if( digit >= 0 && digit <= 9 )
     {
-        fprintf( stderr, "ERREUR - Echec lecture fichier image: %s\n", imageFile );
-        return( 3 );
-    }
+        // Copie du chiffre
+        sample->digit = digit;
 
-    // Normalisation et stockage de pixels comme entrees de l'echantillon
-    for( uint32_t i = 0; i < sample->inputSize; ++i )
+        // Initialisation des sorties attendues pour l'echantillon
+        assert( sample->outputSize >= SAMPLE_OUTPUT_SIZE );
+        sample->outputSize = SAMPLE_OUTPUT_SIZE;
+        for( uint16_t i = 0; i < SAMPLE_OUTPUT_SIZE; ++i )
+        {
+            // La probabilite est a 1 pour le chiffre fourni et 0 pour les autres
+            sample->output[i] = ( i == digit ? 1.0 : 0.0 );
+        }
+    }
+    else
     {
-        sample->input[i] = (double)buff[i] / (double)maxValue;
+        // Pas d'etiquette (echantillon de test)
+        sample->digit = -1;
     }
-
-    // Fermeture du fichier
-    fclose( file );
-
-    return( 0 );
 }
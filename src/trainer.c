@@ -0,0 +1,265 @@
+#include "ia/trainer.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Local
+#include "ia/kernel.h"
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Contexte d'un thread d'apprentissage
+ *
+ */
+typedef struct
+{
+    Trainer* trainer;               // Apprentissage parallele
+    uint32_t index;                 // Rang du thread
+    uint32_t nbLearned;             // Nombre d'echantillons appris par le thread
+} Worker;
+
+/** Chargement des images first..first+count-1 (positions dans l'ordre de l'apprentissage) dans les echantillons
+ *  du lot specifie (sans allocation)
+ *
+ *  Retourne le nombre d'echantillons effectivement charges
+ */
+static uint32_t loadBatch( const Trainer* trainer, uint32_t first, uint32_t count, Sample** batch );
+
+/** Ajout au suivi de l'apprentissage des resultats du lot propage (sorties du reseau dans l'espace de travail)
+ *
+ */
+static void addToReport( const Trainer* trainer, const Workspace* workspace, Sample** batch, uint32_t nbSamples );
+
+/** Attente du lancement de tous les threads d'apprentissage
+ *
+ *  Retourne 0 si l'apprentissage peut commencer (abandonne sinon)
+ */
+static int waitStart( Trainer* trainer );
+
+/** Thread d'apprentissage synchrone
+ *
+ */
+static void* runSync( void* arg );
+
+/** Thread d'apprentissage sans synchronisation (Hogwild)
+ *
+ */
+static void* runHogwild( void* arg );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Trainer* TRAINER_create( Network* network, const Config* cfg )
+{
+    // Allocation de la struture de donnees
+    Trainer* trainer = (Trainer*)malloc( sizeof( Trainer ) );
+    memset( trainer, 0, sizeof( Trainer ) );
+    trainer->network = network;
+    trainer->hogwild = cfg->hogwild;
+    trainer->batchSize = network->batchSize;
+
+    // Nombre de threads (tous les coeurs disponibles si non specifie)
+    trainer->nbThreads = cfg->nbThreads;
+    if( trainer->nbThreads == 0 ) trainer->nbThreads = (uint32_t)sysconf( _SC_NPROCESSORS_ONLN );
+
+    // Un espace de travail et un lot d'echantillons par thread
+    trainer->workspaces = (Workspace**)malloc( trainer->nbThreads * sizeof( Workspace* ) );
+    trainer->batches = (Sample***)malloc( trainer->nbThreads * sizeof( Sample** ) );
+    for( uint32_t i = 0; i < trainer->nbThreads; ++i )
+    {
+        trainer->workspaces[i] = WORKSPACE_create( network, trainer->batchSize, 1 );
+        trainer->batches[i] = SAMPLE_createPool( trainer->batchSize, network->input->nbNeurons,
+                                                 network->output->nbNeurons );
+    }
+    pthread_barrier_init( &trainer->barrier, NULL, trainer->nbThreads );
+    pthread_mutex_init( &trainer->gate, NULL );
+    trainer->nbLoaded = (uint32_t*)calloc( trainer->nbThreads, sizeof( uint32_t ) );
+
+    return( trainer );
+}
+
+
+uint32_t TRAINER_run( Trainer* trainer, const Dataset* dataset, const uint32_t* order, uint32_t nbSamples )
+{
+    // Echantillons a apprendre
+    trainer->nbSamples = ( nbSamples < dataset->nbSamples ? nbSamples : dataset->nbSamples );
+    trainer->dataset = dataset;
+    trainer->order = order;
+
+    // Lancement des threads d'apprentissage, retenus jusqu'a ce que tous soient lances (en mode synchrone,
+    // un thread manquant bloquerait les autres a la barriere : l'apprentissage est alors abandonne)
+    pthread_t* threads = (pthread_t*)malloc( trainer->nbThreads * sizeof( pthread_t ) );
+    Worker* workers = (Worker*)calloc( trainer->nbThreads, sizeof( Worker ) );
+    uint32_t nbStarted = 0;
+    trainer->aborted = 0;
+    pthread_mutex_lock( &trainer->gate );
+    for( ; nbStarted < trainer->nbThreads; ++nbStarted )
+    {
+        workers[nbStarted].trainer = trainer;
+        workers[nbStarted].index = nbStarted;
+        if( pthread_create( &threads[nbStarted], NULL, ( trainer->hogwild ? runHogwild : runSync ),
+                            &workers[nbStarted] ) != 0 )
+        {
+            fprintf( stderr, "ERREUR - Impossible de lancer le thread d'apprentissage %u\n", nbStarted + 1 );
+            trainer->aborted = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock( &trainer->gate );
+
+    // Attente de la fin de l'apprentissage
+    uint32_t nbLearned = 0;
+    for( uint32_t i = 0; i < nbStarted; ++i )
+    {
+        pthread_join( threads[i], NULL );
+        nbLearned += workers[i].nbLearned;
+    }
+
+    // Liberation memoire
+    free( workers );
+    free( threads );
+
+    return( nbLearned );
+}
+
+
+void TRAINER_destroy( Trainer* trainer )
+{
+    // Si valide
+    if( trainer != NULL )
+    {
+        // Liberation des espaces de travail et des echantillons
+        for( uint32_t i = 0; i < trainer->nbThreads; ++i )
+        {
+            WORKSPACE_destroy( trainer->workspaces[i] );
+            SAMPLE_destroyPool( trainer->batches[i], trainer->batchSize );
+        }
+
+        // Liberation memoire
+        pthread_barrier_destroy( &trainer->barrier );
+        pthread_mutex_destroy( &trainer->gate );
+        free( trainer->workspaces );
+        free( trainer->batches );
+        free( trainer->nbLoaded );
+        free( trainer );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static uint32_t loadBatch( const Trainer* trainer, uint32_t first, uint32_t count, Sample** batch )
+{
+    // Chargement de chaque image dans l'echantillon suivant du lot (les images illisibles sont ignorees)
+    uint32_t nbLoaded = 0;
+    for( uint32_t i = first; i < first + count && i < trainer->nbSamples; ++i )
+    {
+        const uint32_t index = ( trainer->order != NULL ? trainer->order[i] : i );
+        if( DATASET_loadSample( trainer->dataset, index, 1, batch[nbLoaded] ) == 0 ) nbLoaded++;
+    }
+
+    return( nbLoaded );
+}
+
+
+static void addToReport( const Trainer* trainer, const Workspace* workspace, Sample** batch, uint32_t nbSamples )
+{
+    const Layer* output = trainer->network->output;
+    REPORT_addBatch( trainer->report, workspace->outputs[output->index], output->nbNeurons, batch, nbSamples );
+}
+
+
+static int waitStart( Trainer* trainer )
+{
+    pthread_mutex_lock( &trainer->gate );
+    const uint8_t aborted = trainer->aborted;
+    pthread_mutex_unlock( &trainer->gate );
+
+    return( aborted );
+}
+
+
+static void* runSync( void* arg )
+{
+    Worker* worker = (Worker*)arg;
+    Trainer* trainer = worker->trainer;
+    if( waitStart( trainer ) != 0 ) return( NULL );
+    Workspace* workspace = trainer->workspaces[worker->index];
+    Sample** batch = trainer->batches[worker->index];
+
+    // A chaque etape, les threads traitent chacun un lot consecutif d'echantillons
+    const uint32_t stepSize = trainer->nbThreads * trainer->batchSize;
+    for( uint32_t first = 0; first < trainer->nbSamples; first += stepSize )
+    {
+        // Calcul des gradients du lot du thread (sans modifier les poids)
+        const uint32_t nbLoaded = loadBatch( trainer, first + worker->index * trainer->batchSize,
+                                             trainer->batchSize, batch );
+        if( nbLoaded > 0 ) NETWORK_computeGradients( trainer->network, workspace, batch, nbLoaded );
+        if( nbLoaded > 0 && trainer->report != NULL ) addToReport( trainer, workspace, batch, nbLoaded );
+        worker->nbLearned += nbLoaded;
+        trainer->nbLoaded[worker->index] = nbLoaded;
+
+        // Une etape de mise a jour commune a tous les threads (son pas n'est lu qu'apres la barriere)
+        if( worker->index == 0 ) trainer->stepRate = NETWORK_beginUpdate( trainer->network );
+
+        // Attente des gradients de tous les threads
+        pthread_barrier_wait( &trainer->barrier );
+
+        // Nombre d'echantillons de l'etape (tous threads confondus)
+        uint32_t nbStep = 0;
+        for( uint32_t t = 0; t < trainer->nbThreads; ++t ) nbStep += trainer->nbLoaded[t];
+
+        // Pour chaque couche, le thread somme les gradients de tous les threads pour sa part des neurones,
+        // puis met a jour les poids de ces neurones
+        for( Layer* layer = trainer->network->input->next; layer != NULL; layer = layer->next )
+        {
+            const uint32_t begin = (uint32_t)( (uint64_t)layer->nbNeurons * worker->index / trainer->nbThreads );
+            const uint32_t end = (uint32_t)( (uint64_t)layer->nbNeurons * ( worker->index + 1 ) / trainer->nbThreads );
+            if( begin == end || nbStep == 0 ) continue;
+
+            const size_t offset = (size_t)begin * layer->nbInputs;
+            const uint32_t size = ( end - begin ) * layer->nbInputs;
+            Real* gradients = trainer->workspaces[0]->gradients[layer->index];
+            for( uint32_t t = 1; t < trainer->nbThreads; ++t )
+            {
+                Real* other = trainer->workspaces[t]->gradients[layer->index];
+                KERNEL_axpy( gradients + offset, 1.0, other + offset, size );
+                memset( other + offset, 0, size * sizeof( Real ) );
+            }
+            LAYER_applyGradientRows( layer, nbStep, gradients, trainer->stepRate, begin, end - begin );
+        }
+
+        // Attente de la mise a jour de tous les poids avant l'etape suivante
+        pthread_barrier_wait( &trainer->barrier );
+    }
+
+    return( NULL );
+}
+
+
+static void* runHogwild( void* arg )
+{
+    Worker* worker = (Worker*)arg;
+    Trainer* trainer = worker->trainer;
+    if( waitStart( trainer ) != 0 ) return( NULL );
+    Workspace* workspace = trainer->workspaces[worker->index];
+    Sample** batch = trainer->batches[worker->index];
+
+    // Chaque thread traite une tranche contigue des echantillons
+    const uint32_t begin = (uint32_t)( (uint64_t)trainer->nbSamples * worker->index / trainer->nbThreads );
+    const uint32_t end = (uint32_t)( (uint64_t)trainer->nbSamples * ( worker->index + 1 ) / trainer->nbThreads );
+    for( uint32_t first = begin; first < end; first += trainer->batchSize )
+    {
+        // Apprentissage sur le lot, les poids partages etant mis a jour sans verrou
+        const uint32_t count = ( end - first < trainer->batchSize ? end - first : trainer->batchSize );
+        const uint32_t nbLoaded = loadBatch( trainer, first, count, batch );
+        if( nbLoaded > 0 ) NETWORK_applyBatch( trainer->network, workspace, batch, nbLoaded );
+        if( nbLoaded > 0 && trainer->report != NULL ) addToReport( trainer, workspace, batch, nbLoaded );
+        worker->nbLearned += nbLoaded;
+    }
+
+    return( NULL );
+}
@@ -0,0 +1,326 @@
+#include "ia/validator.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Local
+#include "ia/checkpoint.h"
+
+// Nombre d'echantillons propages ensemble lors d'une validation
+#define BATCH_SIZE 16
+
+
+//--- Declaration des fonctions locales ------------------------------------------------------------------------
+
+/** Thread de validation : validation de chaque instantane soumis
+ *
+ */
+static void* run( void* arg );
+
+/** Classification des images de validation avec l'instantane, et mise a jour de la meilleure validation
+ *
+ */
+static void validate( Validator* validator );
+
+/** Copie des poids et biais de chaque couche du reseau dans un bloc contigu
+ *
+ */
+static void gather( const Network* network, Real* block );
+
+/** Copie d'un bloc contigu dans les poids et biais de chaque couche du reseau
+ *
+ */
+static void scatter( const Real* block, Network* network );
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Validator* VALIDATOR_create( const Network* network, const Config* cfg, const Dataset* dataset,
+                             uint32_t first, uint32_t nbSamples )
+{
+    // Allocation de la struture de donnees
+    Validator* validator = (Validator*)malloc( sizeof( Validator ) );
+    memset( validator, 0, sizeof( Validator ) );
+    validator->dataset = dataset;
+    validator->first = first;
+    validator->nbSamples = nbSamples;
+    validator->interval = cfg->validationInterval;
+    validator->nextValidation = cfg->validationInterval;
+    validator->patience = cfg->patience;
+    if( cfg->keepBest && cfg->checkpointPath[0] != '\0' ) validator->checkpointPath = cfg->checkpointPath;
+    atomic_init( &validator->stop, 0 );
+
+    // Bloc des poids et biais de l'instantane, dont les couches du reseau valide utilisent directement les
+    // tranches (l'entree 0 des tableaux, correspondant a la couche d'entree, n'est pas utilisee)
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        validator->size += (size_t)layer->nbNeurons * ( layer->nbInputs + 1 );
+    }
+    validator->weights = (Real*)malloc( validator->size * sizeof( Real ) );
+    validator->best = (Real*)malloc( validator->size * sizeof( Real ) );
+    Real* weights[CHECKPOINT_MAX_LAYERS] = { NULL };
+    Real* bias[CHECKPOINT_MAX_LAYERS] = { NULL };
+    Real* slice = validator->weights;
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        weights[layer->index] = slice;
+        slice += (size_t)layer->nbNeurons * layer->nbInputs;
+        bias[layer->index] = slice;
+        slice += layer->nbNeurons;
+    }
+    validator->snapshot = NETWORK_createMapped( cfg, weights, bias, NULL, 0 );
+
+    // Espace de travail et echantillons de la classification
+    validator->workspace = WORKSPACE_create( validator->snapshot, BATCH_SIZE, 0 );
+    validator->batch = SAMPLE_createPool( BATCH_SIZE, network->input->nbNeurons, network->output->nbNeurons );
+
+    // Suivi des validations (un bilan par validation)
+    validator->report = REPORT_create( cfg );
+    validator->report->interval = 0;
+
+    // Lancement du thread de validation
+    pthread_mutex_init( &validator->mutex, NULL );
+    pthread_cond_init( &validator->cond, NULL );
+    validator->running = ( pthread_create( &validator->thread, NULL, run, validator ) == 0 );
+    if( !validator->running )
+    {
+        fprintf( stderr, "ERREUR - Impossible de lancer le thread de validation\n" );
+        VALIDATOR_destroy( validator );
+        return( NULL );
+    }
+
+    return( validator );
+}
+
+
+void VALIDATOR_step( Validator* validator, const Network* network, uint32_t nbSamples )
+{
+    // Validation a intervalle regulier (l'instantane est ignore si la validation precedente est en cours)
+    validator->nbLearned += nbSamples;
+    if( validator->interval > 0 && validator->nbLearned >= validator->nextValidation )
+    {
+        VALIDATOR_submit( validator, network );
+        while( validator->nextValidation <= validator->nbLearned ) validator->nextValidation += validator->interval;
+    }
+}
+
+
+int VALIDATOR_submit( Validator* validator, const Network* network )
+{
+    pthread_mutex_lock( &validator->mutex );
+
+    // L'instantane precedent est encore en cours de validation : celui-ci est ignore (l'apprentissage
+    // n'attend jamais la validation)
+    if( validator->pending )
+    {
+        validator->nbSkipped++;
+        pthread_mutex_unlock( &validator->mutex );
+        return( 0 );
+    }
+
+    // Copie des poids, et reveil du thread de validation
+    gather( network, validator->weights );
+    validator->position = validator->nbLearned;
+    validator->pending = 1;
+    pthread_cond_broadcast( &validator->cond );
+
+    pthread_mutex_unlock( &validator->mutex );
+
+    return( 1 );
+}
+
+
+int VALIDATOR_shouldStop( const Validator* validator )
+{
+    return( atomic_load_explicit( &validator->stop, memory_order_relaxed ) );
+}
+
+
+void VALIDATOR_finish( Validator* validator, const Network* network )
+{
+    // Attente de la fin de la validation en cours
+    pthread_mutex_lock( &validator->mutex );
+    while( validator->pending ) pthread_cond_wait( &validator->cond, &validator->mutex );
+    const uint8_t validated = ( validator->nbValidations > 0 && validator->position == validator->nbLearned );
+    pthread_mutex_unlock( &validator->mutex );
+
+    // Validation des derniers poids (s'ils ne l'ont pas deja ete), et attente du resultat
+    if( !validated && !VALIDATOR_shouldStop( validator ) && VALIDATOR_submit( validator, network ) )
+    {
+        pthread_mutex_lock( &validator->mutex );
+        while( validator->pending ) pthread_cond_wait( &validator->cond, &validator->mutex );
+        pthread_mutex_unlock( &validator->mutex );
+    }
+
+    // Bilan des validations
+    fprintf( stdout, "INFO - Validation : %u validations (%u instantanes ignores)", validator->nbValidations,
+             validator->nbSkipped );
+    if( validator->bestValidation > 0 )
+    {
+        fprintf( stdout, ", meilleure precision = %.2f %% (validation %u, apres %llu echantillons)",
+                 validator->bestAccuracy, validator->bestValidation,
+                 (unsigned long long)validator->bestPosition );
+    }
+    fprintf( stdout, "%s\n", VALIDATOR_shouldStop( validator ) ? ", arret anticipe" : "" );
+}
+
+
+int VALIDATOR_restoreBest( const Validator* validator, Network* network )
+{
+    if( validator->bestValidation == 0 ) return( 1 );
+    scatter( validator->best, network );
+
+    return( 0 );
+}
+
+
+void VALIDATOR_destroy( Validator* validator )
+{
+    // Si valide
+    if( validator != NULL )
+    {
+        // Arret du thread de validation (s'il a ete lance)
+        pthread_mutex_lock( &validator->mutex );
+        validator->exit = 1;
+        pthread_cond_broadcast( &validator->cond );
+        pthread_mutex_unlock( &validator->mutex );
+        if( validator->running ) pthread_join( validator->thread, NULL );
+
+        // Liberation memoire
+        pthread_cond_destroy( &validator->cond );
+        pthread_mutex_destroy( &validator->mutex );
+        REPORT_destroy( validator->report );
+        SAMPLE_destroyPool( validator->batch, BATCH_SIZE );
+        WORKSPACE_destroy( validator->workspace );
+        NETWORK_destroy( validator->snapshot );
+        free( validator->weights );
+        free( validator->best );
+        free( validator );
+    }
+}
+
+//--- Fonctions locales ----------------------------------------------------------------------------------------
+
+static void* run( void* arg )
+{
+    Validator* validator = (Validator*)arg;
+
+    pthread_mutex_lock( &validator->mutex );
+    while( 1 )
+    {
+        // Attente d'un instantane (ou de la fin demandee)
+        while( !validator->pending && !validator->exit ) pthread_cond_wait( &validator->cond, &validator->mutex );
+        if( !validator->pending ) break;
+
+        // Validation hors verrou : l'instantane n'est pas modifie tant qu'il est en attente
+        pthread_mutex_unlock( &validator->mutex );
+        validate( validator );
+        pthread_mutex_lock( &validator->mutex );
+
+        // Fin de la validation signalee (un nouvel instantane peut etre soumis)
+        validator->pending = 0;
+        pthread_cond_broadcast( &validator->cond );
+    }
+    pthread_mutex_unlock( &validator->mutex );
+
+    return( NULL );
+}
+
+
+static void validate( Validator* validator )
+{
+    const Network* network = validator->snapshot;
+    const Layer* output = network->output;
+    const Real* outputs = validator->workspace->outputs[output->index];
+    Report* report = validator->report;
+    REPORT_begin( report, "validation", validator->nbSamples );
+
+    // Classification des images de validation, par lots (les echantillons etant charges sans etiquette, le
+    // chiffre attendu est celui du jeu de donnees)
+    const uint32_t end = validator->first + validator->nbSamples;
+    uint32_t indexes[BATCH_SIZE];
+    for( uint32_t first = validator->first; first < end; first += BATCH_SIZE )
+    {
+        uint32_t nbLoaded = 0;
+        for( uint32_t i = first; i < end && i < first + BATCH_SIZE; ++i )
+        {
+            if( DATASET_loadSample( validator->dataset, i, 0, validator->batch[nbLoaded] ) != 0 ) continue;
+            indexes[nbLoaded++] = i;
+        }
+        if( nbLoaded == 0 ) continue;
+
+        NETWORK_infer( network, validator->workspace, validator->batch, nbLoaded );
+        double loss = 0.0;
+        uint32_t nbCorrect = 0;
+        for( uint32_t i = 0; i < nbLoaded; ++i )
+        {
+            uint8_t correct = 0;
+            loss += REPORT_loss( outputs + (size_t)i * output->nbNeurons, output->nbNeurons,
+                                 validator->dataset->labels[indexes[i]], &correct );
+            nbCorrect += correct;
+        }
+        REPORT_add( report, nbLoaded, nbCorrect, loss, nbLoaded );
+    }
+    REPORT_end( report );
+
+    // Amelioration : meilleure precision, ou meme precision avec une perte plus faible
+    const ReportStats* stats = &report->total;
+    const double accuracy = ( stats->nbSamples > 0 ? 100.0 * stats->nbCorrect / stats->nbSamples : 0.0 );
+    const double loss = ( stats->nbLoss > 0 ? stats->loss / stats->nbLoss : 0.0 );
+    validator->nbValidations++;
+    if( validator->bestValidation == 0 || accuracy > validator->bestAccuracy ||
+        ( accuracy == validator->bestAccuracy && loss < validator->bestLoss ) )
+    {
+        // Conservation des poids, et sauvegarde du reseau (si demande)
+        validator->bestValidation = validator->nbValidations;
+        validator->bestPosition = validator->position;
+        validator->bestAccuracy = accuracy;
+        validator->bestLoss = loss;
+        validator->nbStale = 0;
+        memcpy( validator->best, validator->weights, validator->size * sizeof( Real ) );
+        if( validator->checkpointPath != NULL && CHECKPOINT_save( network, validator->checkpointPath ) != 0 )
+        {
+            fprintf( stderr, "ERREUR - Echec de sauvegarde de la meilleure validation : %s\n",
+                     validator->checkpointPath );
+        }
+    }
+    else
+    {
+        validator->nbStale++;
+    }
+    fprintf( stdout, "INFO - Validation %u (apres %llu echantillons) : meilleure = validation %u, "
+             "%u sans amelioration\n", validator->nbValidations, (unsigned long long)validator->position,
+             validator->bestValidation, validator->nbStale );
+
+    // Arret anticipe apres trop de validations sans amelioration
+    if( validator->patience > 0 && validator->nbStale >= validator->patience )
+    {
+        atomic_store_explicit( &validator->stop, 1, memory_order_relaxed );
+    }
+}
+
+
+static void gather( const Network* network, Real* block )
+{
+    for( const Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        const size_t nbWeights = (size_t)layer->nbNeurons * layer->nbInputs;
+        memcpy( block, layer->weights, nbWeights * sizeof( Real ) );
+        memcpy( block + nbWeights, layer->bias, layer->nbNeurons * sizeof( Real ) );
+        block += nbWeights + layer->nbNeurons;
+    }
+}
+
+
+static void scatter( const Real* block, Network* network )
+{
+    for( Layer* layer = network->input->next; layer != NULL; layer = layer->next )
+    {
+        const size_t nbWeights = (size_t)layer->nbNeurons * layer->nbInputs;
+        memcpy( layer->weights, block, nbWeights * sizeof( Real ) );
+        memcpy( layer->bias, block + nbWeights, layer->nbNeurons * sizeof( Real ) );
+        block += nbWeights + layer->nbNeurons;
+    }
+}
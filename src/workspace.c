@@ -0,0 +1,65 @@
+#include "ia/workspace.h"
+
+// System
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Local
+#include "ia/network.h"
+#include "ia/matrix.h"
+
+
+//--- Fonctions publiques --------------------------------------------------------------------------------------
+
+Workspace* WORKSPACE_create( const struct Network* network, uint32_t capacity, uint8_t training )
+{
+    // Allocation de la struture de donnees
+    Workspace* workspace = (Workspace*)malloc( sizeof( Workspace ) );
+    memset( workspace, 0, sizeof( Workspace ) );
+    workspace->capacity = capacity;
+
+    // Le reseau comprend la couche d'entree, les couches internes et la couche de sortie
+    workspace->nbLayers = network->nbInternals + 2;
+    workspace->outputs = (Real**)calloc( workspace->nbLayers, sizeof( Real* ) );
+    workspace->errors = (Real**)calloc( workspace->nbLayers, sizeof( Real* ) );
+    workspace->gradients = (Real**)calloc( workspace->nbLayers, sizeof( Real* ) );
+
+    // Pour chaque couche
+    for( const Layer* layer = network->input; layer != NULL; layer = layer->next )
+    {
+        // Sorties de la couche pour chaque echantillon du lot
+        workspace->outputs[layer->index] = MATRIX_create( capacity, layer->nbNeurons );
+
+        // Les erreurs et gradients ne concernent que l'apprentissage, et les couches qui ont des poids
+        if( training && layer->previous != NULL )
+        {
+            workspace->errors[layer->index] = MATRIX_create( capacity, layer->nbNeurons );
+            workspace->gradients[layer->index] = MATRIX_create( layer->nbNeurons, layer->nbInputs );
+        }
+    }
+
+    return( workspace );
+}
+
+
+void WORKSPACE_destroy( Workspace* workspace )
+{
+    // Si valide
+    if( workspace != NULL )
+    {
+        // Liberation des buffers de chaque couche
+        for( uint16_t i = 0; i < workspace->nbLayers; ++i )
+        {
+            MATRIX_destroy( workspace->outputs[i] );
+            MATRIX_destroy( workspace->errors[i] );
+            MATRIX_destroy( workspace->gradients[i] );
+        }
+
+        // Liberation memoire
+        free( workspace->outputs );
+        free( workspace->errors );
+        free( workspace->gradients );
+        free( workspace );
+    }
+}